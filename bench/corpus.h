@@ -0,0 +1,326 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+#ifndef VTDEC_BENCH_CORPUS_H
+#define VTDEC_BENCH_CORPUS_H
+
+#include <cstddef>
+#include <string>
+
+namespace vtdec::bench::corpus
+{
+
+/**
+ * Generate plain text, as from a cat of source code.
+ *
+ * @param size The approximate size in bytes
+ * @return The corpus
+ */
+inline std::string plain_text(std::size_t size)
+{
+    static constexpr const char* lines[] = {
+            "#include <vtdec/decode.h>",
+            "",
+            "int main(int argc, char* argv[])",
+            "{",
+            "    // Decode standard input until end of file",
+            "    for (std::string line; std::getline(std::cin, line);)",
+            "    {",
+            "        state = vtdec::decode(std::string_view {line}, proc, state);",
+            "    }",
+            "",
+            "    return 0;",
+            "}",
+    };
+
+    std::string out;
+    out.reserve(size + 128);
+
+    for (std::size_t i = 0; out.size() < size; ++i)
+    {
+        out += lines[i % 12];
+        out += "\r\n";
+    }
+
+    return out;
+}
+
+/**
+ * Generate a colored directory listing, as from ls -l --color.
+ *
+ * @param size The approximate size in bytes
+ * @return The corpus
+ */
+inline std::string ls_color(std::size_t size)
+{
+    static constexpr const char* names[] = {
+            "\x1b[0m\x1b[01;34mbench\x1b[0m",
+            "\x1b[01;34minclude\x1b[0m",
+            "CMakeLists.txt",
+            "\x1b[01;32mconfigure\x1b[0m",
+            "\x1b[01;31marchive.tar.gz\x1b[0m",
+            "\x1b[01;36mlatest\x1b[0m -> \x1b[01;34mrelease-1.2.3\x1b[0m",
+    };
+
+    std::string out;
+    out.reserve(size + 128);
+
+    for (std::size_t i = 0; out.size() < size; ++i)
+    {
+        out += i % 3 ? "-rw-r--r--" : "drwxr-xr-x";
+        out += " 1 user user ";
+        out += std::to_string(i * 4099 % 100000);
+        out += " Jun  1 12:34 ";
+        out += names[i % 6];
+        out += "\r\n";
+    }
+
+    return out;
+}
+
+/**
+ * Generate colored log output: short lines of text with SGR sequences.
+ *
+ * @param size The approximate size in bytes
+ * @return The corpus
+ */
+inline std::string sgr_log(std::size_t size)
+{
+    static constexpr const char* levels[] = {
+            "\x1b[32mINFO\x1b[0m",
+            "\x1b[33mWARN\x1b[0m",
+            "\x1b[1;31mERROR\x1b[0m",
+            "\x1b[2;37mDEBUG\x1b[0m",
+    };
+
+    std::string out;
+    out.reserve(size + 128);
+
+    for (std::size_t i = 0; out.size() < size; ++i)
+    {
+        out += "\x1b[90m2018-06-0";
+        out += static_cast<char>('1' + i % 9);
+        out += "T12:34:56Z\x1b[0m ";
+        out += levels[i % 4];
+        out += " worker-";
+        out += std::to_string(i % 16);
+        out += ": processed request in ";
+        out += std::to_string(i * 7 % 1000);
+        out += "ms\r\n";
+    }
+
+    return out;
+}
+
+/**
+ * Generate UTF-8 text in Chinese and Japanese with some color, as from a log
+ * or a chat client.
+ *
+ * @param size The approximate size in bytes
+ * @return The corpus
+ */
+inline std::string utf8_cjk(std::size_t size)
+{
+    static constexpr const char* lines[] = {
+            "\xe6\x97\xa5\xe5\xbf\x97\xef\xbc\x9a\xe5\xa4\x84\xe7\x90\x86\xe8\xaf\xb7\xe6\xb1\x82\xe5\xae\x8c\xe6\x88\x90",
+            "\x1b[32m\xe6\x88\x90\xe5\x8a\x9f\x1b[0m \xe7\xbc\x96\xe8\xaf\x91 vtdec \xe7\x94\xa8\xe6\x97\xb6 12 \xe6\xaf\xab\xe7\xa7\x92",
+            "\xe3\x81\x93\xe3\x82\x93\xe3\x81\xab\xe3\x81\xa1\xe3\x81\xaf\xe3\x80\x81\xe4\xb8\x96\xe7\x95\x8c\xef\xbc\x81",
+            "\x1b[1;33m\xe8\xad\xa6\xe5\x91\x8a\x1b[0m: \xe3\x83\x95\xe3\x82\xa1\xe3\x82\xa4\xe3\x83\xab\xe3\x81\x8c\xe8\xa6\x8b\xe3\x81\xa4\xe3\x81\x8b\xe3\x82\x8a\xe3\x81\xbe\xe3\x81\x9b\xe3\x82\x93",
+    };
+
+    std::string out;
+    out.reserve(size + 128);
+
+    for (std::size_t i = 0; out.size() < size; ++i)
+    {
+        out += lines[i % 4];
+        out += "\r\n";
+    }
+
+    return out;
+}
+
+/**
+ * Generate full-screen redraws, as from vim or htop: cursor movement, line
+ * erasure, and 256-color and true-color SGR around short runs of text.
+ *
+ * @param size The approximate size in bytes
+ * @return The corpus
+ */
+inline std::string cursor_stream(std::size_t size)
+{
+    std::string out;
+    out.reserve(size + 4096);
+
+    for (std::size_t frame = 0; out.size() < size; ++frame)
+    {
+        out += "\x1b[?25l\x1b[H";
+
+        for (int row = 1; row <= 48; ++row)
+        {
+            out += "\x1b[";
+            out += std::to_string(row);
+            out += ";1H\x1b[K";
+
+            for (int cell = 0; cell < 4; ++cell)
+            {
+                auto n = (frame + row * 7 + cell * 13) % 256;
+
+                out += "\x1b[38;5;";
+                out += std::to_string(n);
+                out += 'm';
+                out += cell % 2 ? " 12.5% " : "[|||||    ]";
+                out += "\x1b[48;2;";
+                out += std::to_string(n);
+                out += ';';
+                out += std::to_string(255 - n);
+                out += ";64m";
+                out += std::to_string(frame * 31 + row);
+                out += "\x1b[0m";
+            }
+        }
+
+        out += "\x1b[49;1H\x1b[7m-- INSERT --\x1b[27m\x1b[?25h";
+    }
+
+    return out;
+}
+
+/**
+ * Generate clipboard transfers with OSC 52, each carrying a large base64
+ * blob, as from copying in a remote editor.
+ *
+ * @param size The approximate size in bytes
+ * @return The corpus
+ */
+inline std::string osc52(std::size_t size)
+{
+    static constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    std::string out;
+    out.reserve(size + 65536);
+
+    for (std::size_t i = 0; out.size() < size; ++i)
+    {
+        out += "copied\r\n\x1b]52;c;";
+
+        for (std::size_t j = 0; j < 65536; ++j)
+        {
+            out += alphabet[(i * 131 + j * 7 + j / 64) % 64];
+        }
+
+        out += "\x1b\\";
+    }
+
+    return out;
+}
+
+/**
+ * Convert valid UTF-8 to UTF-32, as input to the 32-bit overloads.
+ *
+ * @param str The UTF-8 string
+ * @return The UTF-32 string
+ */
+inline std::u32string to_utf32(const std::string& str)
+{
+    std::u32string out;
+    out.reserve(str.size());
+
+    for (std::size_t i = 0; i < str.size();)
+    {
+        auto c = static_cast<unsigned char>(str[i++]);
+        auto n = c < 0x80 ? 0 : c < 0xe0 ? 1 : c < 0xf0 ? 2 : 3;
+        char32_t cp = n == 0 ? c : c & (0x3f >> n);
+
+        while (n-- > 0)
+        {
+            cp = (cp << 6) | (static_cast<unsigned char>(str[i++]) & 0x3f);
+        }
+
+        out += cp;
+    }
+
+    return out;
+}
+
+/**
+ * Generate Sixel images, as from img2sixel, separated by short captions.
+ *
+ * @param size The approximate size in bytes
+ * @return The corpus
+ */
+inline std::string sixel(std::size_t size)
+{
+    std::string out;
+    out.reserve(size + 4096);
+
+    for (std::size_t i = 0; out.size() < size; ++i)
+    {
+        out += "image-";
+        out += std::to_string(i);
+        out += ".png\r\n\x1bP0;1;0q\"1;1;256;96";
+
+        // Palette
+        for (int c = 0; c < 16; ++c)
+        {
+            out += '#';
+            out += std::to_string(c);
+            out += ";2;";
+            out += std::to_string(c * 6);
+            out += ';';
+            out += std::to_string(100 - c * 6);
+            out += ";50";
+        }
+
+        // Sixel rows, one band of color at a time
+        for (int row = 0; row < 16; ++row)
+        {
+            for (int c = 0; c < 4; ++c)
+            {
+                out += '#';
+                out += std::to_string((row + c) % 16);
+                for (int x = 0; x < 24; ++x)
+                {
+                    out += static_cast<char>(0x3f + (row * 7 + x * 13 + c) % 64);
+                }
+                out += '!';
+                out += std::to_string(16 + (row + c) % 64);
+                out += static_cast<char>(0x3f + (row + c) % 64);
+                out += '$';
+            }
+            out += "-\r\n";
+        }
+
+        out += "\x1b\\";
+    }
+
+    return out;
+}
+
+} // namespace vtdec::bench::corpus
+
+#endif // #ifndef VTDEC_BENCH_CORPUS_H
@@ -0,0 +1,124 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Measures decoding to event records, on its own and followed by a replay,
+ * against decoding straight to a processor.
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <vtdec/decode.h>
+#include <vtdec/event.h>
+
+#include "corpus.h"
+#include "harness.h"
+
+using namespace vtdec::bench;
+
+namespace
+{
+
+/**
+ * A processor that checksums what it sees.
+ */
+struct checksum : vtdec::static_processor<checksum>
+{
+    std::uint64_t sum {};
+
+    void print_run(std::string_view str)
+    { sum += str.size(); }
+
+    void print(char32_t c)
+    { sum += c; }
+
+    void ctl(char c)
+    { sum += c; }
+
+    void csi_dispatch(const vtdec::csi_sequence& seq, char final)
+    { sum += seq.param(0) + final; }
+
+    void osc_data(std::string_view str)
+    { sum += str.size(); }
+};
+
+const std::string sgr = corpus::sgr_log(1 << 20);
+const std::string cursor = corpus::cursor_stream(1 << 20);
+
+/**
+ * Decode straight to the processor.
+ */
+std::size_t run_direct(const std::string& input)
+{
+    checksum proc;
+    vtdec::decode(std::string_view {input}, proc);
+    consume(proc.sum);
+    return input.size();
+}
+
+/**
+ * Decode to event records, a batch at a time, and replay each batch if asked.
+ */
+template<bool Replay>
+std::size_t run_events(const std::string& input)
+{
+    static std::vector<vtdec::event> events(1 << 14);
+    static std::vector<vtdec::csi_sequence> sequences(1 << 10);
+
+    vtdec::event_arena arena {events.data(), events.size(), 0, sequences.data(), sequences.size(), 0};
+    vtdec::decode_state state {};
+    checksum proc;
+
+    std::string_view rest {input};
+
+    while (!rest.empty())
+    {
+        rest.remove_prefix(vtdec::decode_events(rest, arena, state));
+
+        if constexpr (Replay)
+        {
+            vtdec::replay(arena, proc);
+        }
+
+        proc.sum += arena.event_count;
+        arena.clear();
+    }
+
+    consume(proc.sum);
+    return input.size();
+}
+
+registrar r1 {"events/sgr_log/direct", [] { return run_direct(sgr); }};
+registrar r2 {"events/sgr_log/record", [] { return run_events<false>(sgr); }};
+registrar r3 {"events/sgr_log/record_replay", [] { return run_events<true>(sgr); }};
+registrar r4 {"events/cursor/direct", [] { return run_direct(cursor); }};
+registrar r5 {"events/cursor/record", [] { return run_events<false>(cursor); }};
+registrar r6 {"events/cursor/record_replay", [] { return run_events<true>(cursor); }};
+
+} // namespace
@@ -0,0 +1,130 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Measures how session decoding scales across threads, with one heavy session
+ * among many light ones, as when one terminal runs cat on a big log while the
+ * rest sit at a prompt.
+ */
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <vtdec/executor.h>
+
+#include "corpus.h"
+#include "harness.h"
+
+using namespace vtdec::bench;
+
+namespace
+{
+
+/**
+ * A static processor that takes runs.
+ */
+struct session_static : vtdec::static_processor<session_static>
+{
+    std::uint64_t sum {};
+
+    void print_run(std::string_view str)
+    { sum += str.size(); }
+
+    void print(char32_t c)
+    { sum += c; }
+
+    void ctl(char c)
+    { sum += c; }
+
+    void csi_dispatch(const vtdec::csi_sequence& seq, char final)
+    { sum += seq.param(0) + final; }
+
+    void osc_data(std::string_view str)
+    { sum += str.size(); }
+};
+
+constexpr std::size_t sessions = 1024;
+
+const std::string input = corpus::sgr_log(1 << 22);
+
+/**
+ * One batch: a big read for the heavy session, and a read of a few hundred
+ * octets for each light session.
+ */
+const std::vector<vtdec::session_input> batch = [] {
+    std::vector<vtdec::session_input> v;
+    std::string_view rest {input};
+
+    v.push_back({0, rest.substr(0, 1 << 18)});
+    rest.remove_prefix(1 << 18);
+
+    for (std::size_t i = 1; i < sessions; ++i)
+    {
+        v.push_back({i, rest.substr(0, 3 << 10)});
+        rest.remove_prefix(3 << 10);
+    }
+
+    return v;
+}();
+
+template<std::size_t Threads>
+std::size_t run()
+{
+    static vtdec::session_pool<session_static> pool = [] {
+        vtdec::session_pool<session_static> p;
+
+        for (std::size_t i = 0; i < sessions; ++i)
+        {
+            p.open();
+        }
+
+        return p;
+    }();
+
+    static vtdec::session_executor exec {Threads};
+
+    exec.feed(pool, batch.begin(), batch.end());
+
+    std::size_t bytes = 0;
+
+    for (auto&& in : batch)
+    {
+        bytes += in.data.size();
+    }
+
+    consume(pool.target(0).sum);
+    return bytes;
+}
+
+registrar r1 {"executor/sgr_log/1", run<1>};
+registrar r2 {"executor/sgr_log/2", run<2>};
+registrar r3 {"executor/sgr_log/4", run<4>};
+registrar r4 {"executor/sgr_log/8", run<8>};
+
+} // namespace
@@ -0,0 +1,146 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Measures decoding a file through memory-mapped windows, against reading it
+ * into a buffer. The file is written once and is likely in the page cache, so
+ * this measures the cost of getting at the bytes, not the disk.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <unistd.h>
+
+#include <vtdec/decoder.h>
+#include <vtdec/file.h>
+
+#include "corpus.h"
+#include "harness.h"
+
+using namespace vtdec::bench;
+
+namespace
+{
+
+/**
+ * A static processor that takes runs.
+ */
+struct span_static : vtdec::static_processor<span_static>
+{
+    std::uint64_t sum {};
+
+    void print_run(std::string_view str)
+    { sum += str.size(); }
+
+    void print(char32_t c)
+    { sum += c; }
+
+    void ctl(char c)
+    { sum += c; }
+
+    void csi_dispatch(const vtdec::csi_sequence& seq, char final)
+    { sum += seq.param(0) + final; }
+
+    void osc_data(std::string_view str)
+    { sum += str.size(); }
+};
+
+/**
+ * A temporary file holding a log, removed on exit.
+ */
+struct log_file
+{
+    std::string path;
+
+    log_file()
+    {
+        char name[] = "/tmp/vtdec_bench_XXXXXX";
+        auto fd = ::mkstemp(name);
+        path = name;
+
+        auto content = corpus::sgr_log(1 << 26);
+
+        if (fd < 0 || ::write(fd, content.data(), content.size()) != static_cast<ssize_t>(content.size()))
+        {
+            std::perror("vtdec_bench: log_file");
+        }
+
+        ::close(fd);
+    }
+
+    ~log_file()
+    { std::remove(path.c_str()); }
+};
+
+const log_file& file()
+{
+    static log_file f;
+    return f;
+}
+
+template<std::size_t Window>
+std::size_t run_mmap()
+{
+    span_static proc;
+    auto result = vtdec::decode_file(file().path.c_str(), proc, vtdec::decode_config {}, Window);
+    consume(proc.sum);
+    return result.bytes;
+}
+
+std::size_t run_read()
+{
+    static std::vector<char> buffer(1 << 20);
+
+    span_static proc;
+    vtdec::decoder<span_static> dec {proc};
+    std::size_t bytes = 0;
+
+    auto f = std::fopen(file().path.c_str(), "rb");
+
+    for (std::size_t n; (n = std::fread(buffer.data(), 1, buffer.size(), f)) != 0;)
+    {
+        dec.feed(std::string_view {buffer.data(), n});
+        bytes += n;
+    }
+
+    std::fclose(f);
+    dec.flush();
+
+    consume(proc.sum);
+    return bytes;
+}
+
+registrar r1 {"file/sgr_log/mmap_64m", run_mmap<std::size_t {1} << 26>};
+registrar r2 {"file/sgr_log/mmap_2m", run_mmap<std::size_t {1} << 21>};
+registrar r3 {"file/sgr_log/read_1m", run_read};
+
+} // namespace
@@ -0,0 +1,90 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+#ifndef VTDEC_BENCH_HARNESS_H
+#define VTDEC_BENCH_HARNESS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vtdec::bench
+{
+
+/**
+ * A benchmark case.
+ */
+struct bench_case
+{
+    /** The case name. */
+    std::string name;
+
+    /** Run one iteration. Returns the number of input bytes processed. */
+    std::function<std::size_t()> run;
+};
+
+/**
+ * The registry of all benchmark cases.
+ *
+ * @return The registry
+ */
+inline std::vector<bench_case>& registry()
+{
+    static std::vector<bench_case> cases;
+    return cases;
+}
+
+/**
+ * Registers a benchmark case on static initialization.
+ */
+struct registrar
+{
+    registrar(std::string p_name, std::function<std::size_t()> p_run)
+    {
+        registry().push_back({std::move(p_name), std::move(p_run)});
+    }
+};
+
+/**
+ * The sink for consumed values.
+ */
+inline volatile std::uint64_t sink;
+
+/**
+ * Keep a value alive so the optimizer cannot discard the work behind it.
+ *
+ * @param value The value
+ */
+inline void consume(std::uint64_t value)
+{ sink = value; }
+
+} // namespace vtdec::bench
+
+#endif // #ifndef VTDEC_BENCH_HARNESS_H
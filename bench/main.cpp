@@ -0,0 +1,77 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "harness.h"
+
+using namespace vtdec::bench;
+
+int main(int argc, char* argv[])
+{
+    // Optional substring filter on case names
+    const char* filter = argc > 1 ? argv[1] : "";
+
+    // Minimum wall time to spend on each case
+    constexpr auto min_time = std::chrono::milliseconds {250};
+
+    std::printf("%-48s %12s %12s\n", "case", "MB/s", "ns/byte");
+
+    for (auto&& bc : registry())
+    {
+        if (bc.name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        // Warm up caches and branch predictors
+        bc.run();
+
+        std::size_t bytes = 0;
+        std::size_t iters = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::steady_clock::duration {};
+
+        do
+        {
+            bytes += bc.run();
+            ++iters;
+            elapsed = std::chrono::steady_clock::now() - start;
+        }
+        while (elapsed < min_time || iters < 3);
+
+        auto ns = std::chrono::duration<double, std::nano> {elapsed}.count();
+        auto mbps = bytes / (ns / 1e9) / 1e6;
+
+        std::printf("%-48s %12.1f %12.3f\n", bc.name.c_str(), mbps, ns / bytes);
+    }
+
+    return 0;
+}
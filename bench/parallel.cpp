@@ -0,0 +1,146 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Measures how decoding one big stream scales from one thread to many, as
+ * when replaying a long recorded session.
+ *
+ * The records of each chunk are replayed on the calling thread while the
+ * workers decode the next chunks, so with enough cores, throughput tops out
+ * at the speed of replay alone. The replay cases measure that bound.
+ */
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <vtdec/decode.h>
+#include <vtdec/event.h>
+#include <vtdec/parallel.h>
+
+#include "corpus.h"
+#include "harness.h"
+
+using namespace vtdec::bench;
+
+namespace
+{
+
+/**
+ * A static processor that takes runs.
+ */
+struct span_static : vtdec::static_processor<span_static>
+{
+    std::uint64_t sum {};
+
+    void print_run(std::string_view str)
+    { sum += str.size(); }
+
+    void print(char32_t c)
+    { sum += c; }
+
+    void ctl(char c)
+    { sum += c; }
+
+    void csi_dispatch(const vtdec::csi_sequence& seq, char final)
+    { sum += seq.param(0) + final; }
+
+    void osc_data(std::string_view str)
+    { sum += str.size(); }
+};
+
+const std::string sgr = corpus::sgr_log(1 << 24);
+const std::string cjk = corpus::utf8_cjk(1 << 24);
+
+std::size_t run_serial(const std::string& input)
+{
+    span_static proc;
+    vtdec::decode_utf8(std::string_view {input}, proc);
+    consume(proc.sum);
+    return input.size();
+}
+
+template<std::size_t Threads>
+std::size_t run_parallel(const std::string& input)
+{
+    static vtdec::session_executor exec {Threads};
+
+    span_static proc;
+    vtdec::decode_utf8_parallel(input, proc, exec);
+    consume(proc.sum);
+    return input.size();
+}
+
+/**
+ * Replay records made ahead of time from the first 4 MiB of an input.
+ */
+std::size_t run_replay(const std::string& input)
+{
+    struct recorded
+    {
+        std::string_view str;
+        std::vector<vtdec::event> events;
+        std::vector<vtdec::csi_sequence> sequences;
+        vtdec::event_arena arena;
+
+        explicit recorded(const std::string& input)
+                : str {std::string_view {input}.substr(0, 1 << 22)}
+                , events(str.size())
+                , sequences(str.size() / 4)
+                , arena {events.data(), events.size(), 0, sequences.data(), sequences.size(), 0}
+        {
+            vtdec::decode_state state {};
+            vtdec::decode_utf8_events(str, arena, state);
+        }
+    };
+
+    static recorded sgr_records {sgr};
+    static recorded cjk_records {cjk};
+
+    auto& r = &input == &sgr ? sgr_records : cjk_records;
+
+    span_static proc;
+    vtdec::replay(r.arena, proc);
+    consume(proc.sum);
+    return r.str.size();
+}
+
+registrar r1 {"parallel/sgr_log/serial", [] { return run_serial(sgr); }};
+registrar r2 {"parallel/sgr_log/1", [] { return run_parallel<1>(sgr); }};
+registrar r3 {"parallel/sgr_log/2", [] { return run_parallel<2>(sgr); }};
+registrar r4 {"parallel/sgr_log/4", [] { return run_parallel<4>(sgr); }};
+registrar r5 {"parallel/sgr_log/8", [] { return run_parallel<8>(sgr); }};
+registrar r6 {"parallel/sgr_log/replay", [] { return run_replay(sgr); }};
+registrar r7 {"parallel/utf8_cjk/serial", [] { return run_serial(cjk); }};
+registrar r8 {"parallel/utf8_cjk/1", [] { return run_parallel<1>(cjk); }};
+registrar r9 {"parallel/utf8_cjk/2", [] { return run_parallel<2>(cjk); }};
+registrar r10 {"parallel/utf8_cjk/4", [] { return run_parallel<4>(cjk); }};
+registrar r11 {"parallel/utf8_cjk/8", [] { return run_parallel<8>(cjk); }};
+registrar r12 {"parallel/utf8_cjk/replay", [] { return run_replay(cjk); }};
+
+} // namespace
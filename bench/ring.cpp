@@ -0,0 +1,241 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Measures a PTY reader thread feeding a decoder thread, through the byte
+ * ring and through a mutex-guarded deque of buffers for comparison.
+ *
+ * The throughput cases stream a log through in 4 KiB reads. The latency cases
+ * send one 64-byte message at a time and wait for the decoder to dispatch the
+ * SGR sequence at its end before sending the next, so ns/byte times 64 is the
+ * time from bytes in to event out.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <vtdec/decoder.h>
+#include <vtdec/ring.h>
+
+#include "corpus.h"
+#include "harness.h"
+
+using namespace vtdec::bench;
+
+namespace
+{
+
+/**
+ * A static processor that takes runs and counts SGR sequences where the
+ * other thread can see.
+ */
+struct signal_static : vtdec::static_processor<signal_static>
+{
+    std::uint64_t sum {};
+
+    std::atomic<std::size_t> sgr {0};
+
+    void print_run(std::string_view str)
+    { sum += str.size(); }
+
+    void print(char32_t c)
+    { sum += c; }
+
+    void ctl(char c)
+    { sum += c; }
+
+    void csi_dispatch(const vtdec::csi_sequence& seq, char final)
+    {
+        sum += seq.param(0) + final;
+
+        if (final == 'm')
+        {
+            sgr.fetch_add(1, std::memory_order_release);
+        }
+    }
+};
+
+constexpr std::size_t read_size = 4096;
+
+constexpr std::size_t message_size = 64;
+
+constexpr std::size_t messages = 2048;
+
+const std::string input = corpus::sgr_log(1 << 22);
+
+/**
+ * A message of plain text ending in an SGR sequence.
+ */
+const std::string message = std::string(message_size - 4, 'x') + "\x1b[0m";
+
+/**
+ * The byte ring, as a pipe.
+ */
+struct ring_pipe
+{
+    vtdec::byte_ring ring {1 << 16};
+
+    void put(std::string_view str)
+    {
+        while (!str.empty())
+        {
+            auto n = ring.write(str.data(), str.size());
+            str.remove_prefix(n);
+
+            if (n == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    template<class Decoder>
+    bool take(Decoder& dec)
+    { return vtdec::drain(ring, dec) != 0; }
+};
+
+/**
+ * A deque of buffers under a mutex, as a pipe.
+ */
+struct deque_pipe
+{
+    std::mutex mutex;
+    std::deque<std::string> buffers;
+
+    void put(std::string_view str)
+    {
+        std::lock_guard<std::mutex> lock {mutex};
+        buffers.emplace_back(str);
+    }
+
+    template<class Decoder>
+    bool take(Decoder& dec)
+    {
+        std::string buffer;
+
+        {
+            std::lock_guard<std::mutex> lock {mutex};
+
+            if (buffers.empty())
+            {
+                return false;
+            }
+
+            buffer = std::move(buffers.front());
+            buffers.pop_front();
+        }
+
+        dec.feed(buffer);
+        return true;
+    }
+};
+
+/**
+ * Run a decoder thread on a pipe while the calling thread produces.
+ */
+template<class Pipe, class Produce>
+void run_pipe(Pipe& pipe, signal_static& proc, Produce&& produce)
+{
+    std::atomic<bool> done {false};
+
+    std::thread consumer {[&] {
+        vtdec::decoder<signal_static> dec {proc};
+
+        for (;;)
+        {
+            auto last = done.load(std::memory_order_acquire);
+
+            if (!pipe.take(dec))
+            {
+                if (last)
+                {
+                    break;
+                }
+
+                std::this_thread::yield();
+            }
+        }
+
+        dec.flush();
+    }};
+
+    produce();
+
+    done.store(true, std::memory_order_release);
+    consumer.join();
+}
+
+template<class Pipe>
+std::size_t run_throughput()
+{
+    Pipe pipe;
+    signal_static proc;
+
+    run_pipe(pipe, proc, [&] {
+        for (std::size_t i = 0; i < input.size(); i += read_size)
+        {
+            pipe.put(std::string_view {input}.substr(i, read_size));
+        }
+    });
+
+    consume(proc.sum);
+    return input.size();
+}
+
+template<class Pipe>
+std::size_t run_latency()
+{
+    Pipe pipe;
+    signal_static proc;
+
+    run_pipe(pipe, proc, [&] {
+        for (std::size_t i = 1; i <= messages; ++i)
+        {
+            pipe.put(message);
+
+            while (proc.sgr.load(std::memory_order_acquire) != i)
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    consume(proc.sum);
+    return messages * message_size;
+}
+
+registrar r1 {"ring/throughput/ring", run_throughput<ring_pipe>};
+registrar r2 {"ring/throughput/mutex_deque", run_throughput<deque_pipe>};
+registrar r3 {"ring/latency/ring", run_latency<ring_pipe>};
+registrar r4 {"ring/latency/mutex_deque", run_latency<deque_pipe>};
+
+} // namespace
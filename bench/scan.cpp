@@ -0,0 +1,141 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Measures the throughput of the plain text scanner on its own and of the
+ * decoder on text-heavy and image-heavy captures, where the scanners carry
+ * most of the load.
+ */
+
+#include <cstdint>
+#include <string>
+
+#include <vtdec/decode.h>
+#include <vtdec/scan.h>
+
+#include "corpus.h"
+#include "harness.h"
+
+using namespace vtdec::bench;
+
+namespace
+{
+
+const std::string text = corpus::plain_text(1 << 20);
+const std::string ls = corpus::ls_color(1 << 20);
+const std::string six = corpus::sixel(1 << 20);
+
+/**
+ * Count the octets that are not plain text with a scanner.
+ */
+template<const char* (*Scan)(const char*, const char*)>
+std::size_t run_scan()
+{
+    std::uint64_t count = 0;
+
+    auto end = text.data() + text.size();
+    for (auto i = text.data(); i != end; ++i, ++count)
+    {
+        if ((i = Scan(i, end)) == end)
+        {
+            break;
+        }
+    }
+
+    consume(count);
+    return text.size();
+}
+
+/**
+ * A processor that checksums what it sees.
+ */
+struct checksum : vtdec::static_processor<checksum>
+{
+    std::uint64_t sum {};
+
+    void print_run(std::string_view str)
+    { sum += str.size(); }
+
+    void ctl(char c)
+    { sum += c; }
+
+    void ctl_end(bool cancel)
+    { sum += 1; }
+
+    void dcs_hook(const vtdec::csi_sequence& seq, char final)
+    { sum += seq.param_count; }
+
+    void dcs_data(std::string_view str)
+    { sum += str.size(); }
+};
+
+/**
+ * A processor that checksums what it sees, one codepoint at a time.
+ */
+struct checksum_per_char : vtdec::static_processor<checksum_per_char>
+{
+    std::uint64_t sum {};
+
+    void print(char32_t c)
+    { sum += c; }
+
+    void ctl(char c)
+    { sum += c; }
+
+    void ctl_end(bool cancel)
+    { sum += 1; }
+
+    void dcs_put(char32_t c)
+    { sum += c; }
+};
+
+template<class Processor>
+std::size_t run_decode(const std::string& input)
+{
+    Processor proc;
+    vtdec::decode(std::string_view {input}, proc);
+    consume(proc.sum);
+    return input.size();
+}
+
+registrar r1 {"scan/scalar", run_scan<vtdec::detail::scan_scalar<vtdec::detail::text_stops>>};
+registrar r2 {"scan/swar", run_scan<vtdec::detail::scan_swar<vtdec::detail::text_stops>>};
+#if defined(VTDEC_SCAN_SSE2)
+registrar r3 {"scan/sse2", run_scan<vtdec::detail::scan_sse2<vtdec::detail::text_stops>>};
+#endif
+#if defined(VTDEC_SCAN_AVX2)
+registrar r4 {"scan/avx2", run_scan<vtdec::detail::scan_avx2<vtdec::detail::text_stops>>};
+#endif
+
+registrar r5 {"decode/plain_text/print_run", [] { return run_decode<checksum>(text); }};
+registrar r6 {"decode/plain_text/print", [] { return run_decode<checksum_per_char>(text); }};
+registrar r7 {"decode/ls_color/print_run", [] { return run_decode<checksum>(ls); }};
+registrar r8 {"decode/ls_color/print", [] { return run_decode<checksum_per_char>(ls); }};
+registrar r9 {"decode/sixel/dcs_data", [] { return run_decode<checksum>(six); }};
+registrar r10 {"decode/sixel/dcs_put", [] { return run_decode<checksum_per_char>(six); }};
+
+} // namespace
@@ -0,0 +1,149 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Measures many sessions fed small reads, as a multiplexer would see them,
+ * decoded one decode() call per read and decoded in batches by a session
+ * pool.
+ */
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <vtdec/decode.h>
+#include <vtdec/session.h>
+
+#include "corpus.h"
+#include "harness.h"
+
+using namespace vtdec::bench;
+
+namespace
+{
+
+/**
+ * A static processor that takes runs and counts decode operations.
+ */
+struct session_static : vtdec::static_processor<session_static>
+{
+    std::uint64_t sum {};
+
+    void print_run(std::string_view str)
+    { sum += str.size(); }
+
+    void print(char32_t c)
+    { sum += c; }
+
+    void ctl(char c)
+    { sum += c; }
+
+    void csi_dispatch(const vtdec::csi_sequence& seq, char final)
+    { sum += seq.param(0) + final; }
+
+    void osc_data(std::string_view str)
+    { sum += str.size(); }
+
+    void decode_begin()
+    { sum += 1; }
+
+    void decode_end(bool cancel)
+    { sum += 1; }
+};
+
+constexpr std::size_t sessions = 4096;
+constexpr std::size_t read_size = 64;
+
+const std::string input = corpus::sgr_log(1 << 20);
+
+/**
+ * The reads, round robin over the sessions, each session reading its own
+ * window of the input.
+ */
+const std::vector<vtdec::session_input> reads = [] {
+    std::vector<vtdec::session_input> v;
+
+    for (std::size_t off = 0; off + read_size * sessions <= input.size(); off += read_size * sessions)
+    {
+        for (std::size_t i = 0; i < sessions; ++i)
+        {
+            v.push_back({i, std::string_view {input}.substr(off + i * read_size, read_size)});
+        }
+    }
+
+    return v;
+}();
+
+std::size_t run_calls()
+{
+    static std::vector<session_static> procs(sessions);
+    static std::vector<vtdec::decode_state> states(sessions);
+
+    std::size_t bytes = 0;
+
+    for (auto&& in : reads)
+    {
+        states[in.session] = vtdec::decode_utf8(in.data, procs[in.session], states[in.session]);
+        bytes += in.data.size();
+    }
+
+    consume(procs[0].sum);
+    return bytes;
+}
+
+std::size_t run_pool()
+{
+    static vtdec::session_pool<session_static> pool = [] {
+        vtdec::session_pool<session_static> p;
+        p.reserve(sessions);
+
+        for (std::size_t i = 0; i < sessions; ++i)
+        {
+            p.open();
+        }
+
+        return p;
+    }();
+
+    std::size_t bytes = 0;
+
+    // A batch is one round of reads over all sessions
+    for (auto it = reads.begin(); it != reads.end(); it += sessions)
+    {
+        pool.feed(it, it + sessions);
+        bytes += read_size * sessions;
+    }
+
+    consume(pool.target(0).sum);
+    return bytes;
+}
+
+registrar r1 {"session/sgr_log/calls", run_calls};
+registrar r2 {"session/sgr_log/pool", run_pool};
+
+} // namespace
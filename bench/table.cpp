@@ -0,0 +1,90 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Compares the table backends. The iterator overload of decode() is used so
+ * that every octet goes through the table, without the scanner fast path.
+ */
+
+#include <cstdint>
+#include <string>
+
+#include <vtdec/decode.h>
+
+#include "corpus.h"
+#include "harness.h"
+
+using namespace vtdec::bench;
+
+namespace
+{
+
+/**
+ * A processor that checksums what it sees with a given table backend.
+ */
+template<class TableBackend>
+struct checksum : vtdec::static_processor<checksum<TableBackend>>
+{
+    using table_backend = TableBackend;
+
+    std::uint64_t sum {};
+
+    void print(char32_t c)
+    { sum += c; }
+
+    void ctl(char c)
+    { sum += c; }
+
+    void ctl_put(char32_t c)
+    { sum += c; }
+
+    void ctl_end(bool cancel)
+    { sum += 1; }
+};
+
+const std::string sgr = corpus::sgr_log(1 << 20);
+const std::string ls = corpus::ls_color(1 << 20);
+
+template<class TableBackend>
+std::size_t run(const std::string& input)
+{
+    checksum<TableBackend> proc;
+    vtdec::decode(input.begin(), input.end(), proc);
+    consume(proc.sum);
+    return input.size();
+}
+
+registrar r1 {"table/wide/sgr_log", [] { return run<vtdec::table_backend_wide>(sgr); }};
+registrar r2 {"table/packed/sgr_log", [] { return run<vtdec::table_backend_packed>(sgr); }};
+registrar r3 {"table/classes/sgr_log", [] { return run<vtdec::table_backend_classes>(sgr); }};
+registrar r4 {"table/fused/sgr_log", [] { return run<vtdec::table_backend_fused>(sgr); }};
+registrar r5 {"table/wide/ls_color", [] { return run<vtdec::table_backend_wide>(ls); }};
+registrar r6 {"table/packed/ls_color", [] { return run<vtdec::table_backend_packed>(ls); }};
+registrar r7 {"table/classes/ls_color", [] { return run<vtdec::table_backend_classes>(ls); }};
+registrar r8 {"table/fused/ls_color", [] { return run<vtdec::table_backend_fused>(ls); }};
+
+} // namespace
@@ -0,0 +1,151 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Measures the per-byte cost of the decode_put, decode_action, and
+ * decode_transition tracing hooks by decoding the same input with otherwise
+ * identical processors that do and do not want tracing.
+ */
+
+#include <cstdint>
+#include <string>
+
+#include <vtdec/decode.h>
+
+#include "corpus.h"
+#include "harness.h"
+
+using namespace vtdec::bench;
+
+namespace
+{
+
+/**
+ * A static processor with tracing off.
+ */
+struct quiet_static : vtdec::static_processor<quiet_static>
+{
+    std::uint64_t sum {};
+
+    void print(char32_t c)
+    { sum += c; }
+
+    void ctl(char c)
+    { sum += c; }
+
+    void ctl_put(char32_t c)
+    { sum += c; }
+};
+
+/**
+ * A static processor with tracing on.
+ */
+struct traced_static : vtdec::static_processor<traced_static>
+{
+    std::uint64_t sum {};
+
+    void print(char32_t c)
+    { sum += c; }
+
+    void ctl(char c)
+    { sum += c; }
+
+    void ctl_put(char32_t c)
+    { sum += c; }
+
+    void decode_put(char32_t c)
+    { sum += 1; }
+
+    void decode_action(int act)
+    { sum += act; }
+
+    void decode_transition(int src, int dst)
+    { sum += src ^ dst; }
+};
+
+/**
+ * A virtual processor that opts out of tracing.
+ */
+struct quiet_virtual : vtdec::processor
+{
+    static constexpr bool wants_trace = false;
+
+    std::uint64_t sum {};
+
+    void print(char32_t c) override
+    { sum += c; }
+
+    void ctl(char c) override
+    { sum += c; }
+
+    void ctl_put(char32_t c) override
+    { sum += c; }
+};
+
+/**
+ * A virtual processor with tracing on (the default).
+ */
+struct traced_virtual : vtdec::processor
+{
+    std::uint64_t sum {};
+
+    void print(char32_t c) override
+    { sum += c; }
+
+    void ctl(char c) override
+    { sum += c; }
+
+    void ctl_put(char32_t c) override
+    { sum += c; }
+
+    void decode_put(char32_t c) override
+    { sum += 1; }
+
+    void decode_action(int act) override
+    { sum += act; }
+
+    void decode_transition(int src, int dst) override
+    { sum += src ^ dst; }
+};
+
+const std::string input = corpus::sgr_log(1 << 20);
+
+template<class Processor>
+std::size_t run()
+{
+    Processor proc;
+    vtdec::decode(std::string_view {input}, proc);
+    consume(proc.sum);
+    return input.size();
+}
+
+registrar r1 {"trace/off/static", run<quiet_static>};
+registrar r2 {"trace/on/static", run<traced_static>};
+registrar r3 {"trace/off/virtual", run<quiet_virtual>};
+registrar r4 {"trace/on/virtual", run<traced_virtual>};
+
+} // namespace
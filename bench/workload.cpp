@@ -0,0 +1,278 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Measures the decoder end to end on realistic terminal workloads, through
+ * each input overload and for each kind of processor, so that a regression
+ * anywhere in the tables or the decoder shows up against the workload and
+ * the processor it hurts.
+ *
+ * Cases are named workload/<corpus>/<overload>/<processor>. Throughput is
+ * always counted in bytes of UTF-8 input, even for the 32-bit overload, so
+ * the numbers are comparable.
+ */
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <vtdec/decode.h>
+
+#include "corpus.h"
+#include "harness.h"
+
+using namespace vtdec::bench;
+
+namespace
+{
+
+/**
+ * A static processor that takes runs wherever it can.
+ */
+struct span_static : vtdec::static_processor<span_static>
+{
+    std::uint64_t sum {};
+
+    void print_run(std::string_view str)
+    { sum += str.size(); }
+
+    void print_run(std::u32string_view str)
+    { sum += str.size(); }
+
+    void print(char32_t c)
+    { sum += c; }
+
+    void ctl(char c)
+    { sum += c; }
+
+    void csi_dispatch(const vtdec::csi_sequence& seq, char final)
+    { sum += seq.param(0) + final; }
+
+    void dcs_data(std::string_view str)
+    { sum += str.size(); }
+
+    void dcs_put(char32_t c)
+    { sum += c; }
+
+    void osc_data(std::string_view str)
+    { sum += str.size(); }
+
+    void osc_put(char32_t c)
+    { sum += c; }
+};
+
+/**
+ * A static processor that takes one codepoint at a time.
+ */
+struct char_static : vtdec::static_processor<char_static>
+{
+    std::uint64_t sum {};
+
+    void print(char32_t c)
+    { sum += c; }
+
+    void ctl(char c)
+    { sum += c; }
+
+    void csi_dispatch(const vtdec::csi_sequence& seq, char final)
+    { sum += seq.param(0) + final; }
+
+    void dcs_put(char32_t c)
+    { sum += c; }
+
+    void osc_put(char32_t c)
+    { sum += c; }
+};
+
+/**
+ * A virtual processor that takes runs wherever it can.
+ */
+struct span_virtual : vtdec::processor
+{
+    static constexpr bool wants_trace = false;
+
+    std::uint64_t sum {};
+
+    void print_run(std::string_view str) override
+    { sum += str.size(); }
+
+    void print_run(std::u32string_view str) override
+    { sum += str.size(); }
+
+    void print(char32_t c) override
+    { sum += c; }
+
+    void ctl(char c) override
+    { sum += c; }
+
+    void csi_dispatch(const vtdec::csi_sequence& seq, char final) override
+    { sum += seq.param(0) + final; }
+
+    void dcs_data(std::string_view str) override
+    { sum += str.size(); }
+
+    void dcs_put(char32_t c) override
+    { sum += c; }
+
+    void osc_data(std::string_view str) override
+    { sum += str.size(); }
+
+    void osc_put(char32_t c) override
+    { sum += c; }
+};
+
+/**
+ * A virtual processor that takes one codepoint at a time.
+ */
+struct char_virtual : vtdec::processor
+{
+    static constexpr bool wants_trace = false;
+
+    std::uint64_t sum {};
+
+    void print(char32_t c) override
+    { sum += c; }
+
+    void ctl(char c) override
+    { sum += c; }
+
+    void csi_dispatch(const vtdec::csi_sequence& seq, char final) override
+    { sum += seq.param(0) + final; }
+
+    void dcs_put(char32_t c) override
+    { sum += c; }
+
+    void osc_put(char32_t c) override
+    { sum += c; }
+};
+
+/**
+ * A corpus in each form the overloads take.
+ */
+struct workload
+{
+    /** The corpus name. */
+    const char* name;
+
+    /** The corpus as UTF-8. */
+    std::string utf8;
+
+    /** The corpus as UTF-32. */
+    std::u32string utf32;
+
+    /** True if the corpus is all 7-bit, so it means the same as octets, otherwise false. */
+    bool ascii;
+};
+
+workload make_workload(const char* name, std::string str)
+{
+    auto ascii = true;
+
+    for (unsigned char c : str)
+    {
+        ascii = ascii && c < 0x80;
+    }
+
+    auto utf32 = corpus::to_utf32(str);
+    return {name, std::move(str), std::move(utf32), ascii};
+}
+
+const workload workloads[] = {
+        make_workload("plain_ascii", corpus::plain_text(1 << 20)),
+        make_workload("utf8_cjk", corpus::utf8_cjk(1 << 20)),
+        make_workload("sgr_log", corpus::sgr_log(1 << 20)),
+        make_workload("cursor", corpus::cursor_stream(1 << 20)),
+        make_workload("sixel", corpus::sixel(1 << 20)),
+        make_workload("osc52", corpus::osc52(1 << 20)),
+};
+
+/**
+ * Decode a workload as octets with the string_view overload.
+ */
+template<class Processor>
+std::size_t run_octets(const workload& w)
+{
+    Processor proc;
+    vtdec::decode(std::string_view {w.utf8}, proc);
+    consume(proc.sum);
+    return w.utf8.size();
+}
+
+/**
+ * Decode a workload as UTF-8.
+ */
+template<class Processor>
+std::size_t run_utf8(const workload& w)
+{
+    Processor proc;
+    vtdec::decode_utf8(std::string_view {w.utf8}, proc);
+    consume(proc.sum);
+    return w.utf8.size();
+}
+
+/**
+ * Decode a workload as 32-bit codepoints with the u32string_view overload.
+ */
+template<class Processor>
+std::size_t run_utf32(const workload& w)
+{
+    Processor proc;
+    vtdec::decode(std::u32string_view {w.utf32}, proc);
+    consume(proc.sum);
+    return w.utf8.size();
+}
+
+/**
+ * Register the cases for one processor over every workload.
+ */
+template<class Processor>
+void register_processor(const char* name)
+{
+    for (auto& w : workloads)
+    {
+        auto prefix = std::string {"workload/"} + w.name + "/";
+
+        // Octets only mean the same as UTF-8 for 7-bit input
+        if (w.ascii)
+        {
+            registry().push_back({prefix + "octets/" + name, [&w] { return run_octets<Processor>(w); }});
+        }
+
+        registry().push_back({prefix + "utf8/" + name, [&w] { return run_utf8<Processor>(w); }});
+        registry().push_back({prefix + "u32/" + name, [&w] { return run_utf32<Processor>(w); }});
+    }
+}
+
+const bool registered = [] {
+    register_processor<span_static>("span_static");
+    register_processor<char_static>("char_static");
+    register_processor<span_virtual>("span_virtual");
+    register_processor<char_virtual>("char_virtual");
+    return true;
+}();
+
+} // namespace
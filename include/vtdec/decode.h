@@ -28,17 +28,42 @@
 #ifndef VTDEC_DECODE_H
 #define VTDEC_DECODE_H
 
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <limits>
 #include <string_view>
 #include <type_traits>
+#include <utility>
 
 #include <vtdec/processor.h>
+#include <vtdec/scan.h>
+#include <vtdec/sequence.h>
 #include <vtdec/table.h>
 
+/**
+ * Check an invariant of the decoder. The tables are checked at compile time,
+ * so these can only fail on a corrupt decode_state. By default, this is a
+ * standard assert. Define it before including vtdec to report failures some
+ * other way (e.g. to an error callback). The decoder never throws on its own.
+ */
+#ifndef VTDEC_ASSERT
+#define VTDEC_ASSERT(cond) assert(cond)
+#endif
+
 namespace vtdec
 {
 
 /**
  * Transient state for an ongoing decode operation.
+ *
+ * This is everything the decoder carries from one input to the next: the
+ * state and the kind of the current sequence, its parameters and length so
+ * far, and any partial UTF-8 sequence. So, when the state from each call is
+ * passed to the next, input may be split anywhere without changing the
+ * callbacks. A run may be split into more than one, but the codepoints in the
+ * runs stay the same. Only decode_begin and decode_end come once per call.
+ * At the end of the stream, flush takes care of whatever is unfinished.
  */
 struct decode_state
 {
@@ -47,6 +72,43 @@ struct decode_state
 
     /** The index of the current sequence. */
     int sequence;
+
+    /** The bits of a partially-decoded UTF-8 codepoint. */
+    char32_t utf8_codepoint;
+
+    /** The number of UTF-8 continuation octets still expected. */
+    unsigned char utf8_remaining;
+
+    /** The total number of octets in the current UTF-8 sequence. */
+    unsigned char utf8_length;
+
+    /** The parameters of the current control sequence or device control string. */
+    csi_sequence csi;
+
+    /** The number of codepoints passed along so far for the current sequence. */
+    std::size_t length;
+};
+
+/**
+ * Limits on the number of codepoints passed along for each kind of sequence.
+ * This bounds what a processor must buffer for any one sequence, no matter the
+ * input. A sequence that would go over its limit is canceled instead, and the
+ * rest of it is skipped up to its terminator. By default, there are no limits.
+ *
+ * A config type of one's own may be used in place of this one, so long as it
+ * has the same members. If they are static constants, the checks against them
+ * are resolved at compile time.
+ */
+struct decode_config
+{
+    /** The limit for a control sequence (CSI), counting parameters and intermediates. */
+    std::size_t max_csi = std::numeric_limits<std::size_t>::max();
+
+    /** The limit for a device control string (DCS), counting its header and data. */
+    std::size_t max_dcs = std::numeric_limits<std::size_t>::max();
+
+    /** The limit for an operating system command (OSC). */
+    std::size_t max_osc = std::numeric_limits<std::size_t>::max();
 };
 
 /**
@@ -67,12 +129,172 @@ enum sequence
 };
 
 /**
- * Internal. Carry out an action.
+ * Internal. Reset the parameters of a sequence.
+ */
+inline void reset_params(csi_sequence& seq)
+{
+    seq.subparams = 0;
+    seq.param_count = 0;
+    seq.intermediate_count = 0;
+    seq.private_marker = 0;
+    seq.overflow = false;
+}
+
+/**
+ * Internal. Accumulate a parameter character into a sequence.
+ */
+inline void accumulate_param(csi_sequence& seq, char gl)
+{
+    // The first parameter character begins the first parameter
+    if (seq.param_count == 0)
+    {
+        seq.params[0] = 0;
+        seq.param_count = 1;
+    }
+
+    if (gl == ';' || gl == ':')
+    {
+        // Begin the next parameter, if there is room for it
+        if (seq.param_count < csi_sequence::max_params)
+        {
+            if (gl == ':')
+            {
+                seq.subparams |= std::uint32_t {1} << seq.param_count;
+            }
+
+            seq.params[seq.param_count++] = 0;
+        }
+        else
+        {
+            seq.overflow = true;
+        }
+    }
+    else if (!seq.overflow)
+    {
+        // Append a digit to the current parameter, saturating on overflow
+        auto& value = seq.params[seq.param_count - 1];
+        auto next = value * 10u + (gl - '0');
+        value = static_cast<std::uint16_t>(next < csi_sequence::max_value ? next : csi_sequence::max_value);
+    }
+}
+
+/**
+ * Internal. Collect an intermediate or private marker character into a
+ * sequence. Private markers only appear at the start, so a character
+ * collected while still in a parameter state is one.
+ */
+inline void collect_param(csi_sequence& seq, char gl, int state)
+{
+    if (state == state::csi_param || state == state::dcs_param)
+    {
+        seq.private_marker = gl;
+    }
+    else if (seq.intermediate_count < csi_sequence::max_intermediates)
+    {
+        seq.intermediates[seq.intermediate_count++] = gl;
+    }
+    else
+    {
+        seq.overflow = true;
+    }
+}
+
+/**
+ * Internal. Cancel the current sequence after it has hit its limit. The
+ * decoder moves to the state that ignores the rest of the sequence, which
+ * leaves the same way, so the terminator is still found. No leave action is
+ * taken, as the processor has already been told.
  */
 template<class Processor>
-static decode_state do_action(Processor&& p, decode_state s, int act, char c)
+void truncate(Processor&& p, decode_state& s)
+{
+    int tgt;
+
+    switch (s.sequence)
+    {
+    case sequence::ctl:
+        p.ctl_end(true);
+        tgt = state::csi_ignore;
+        break;
+    case sequence::dcs:
+        p.dcs_end(true);
+        tgt = state::dcs_ignore;
+        break;
+    case sequence::osc:
+        // BEL does not end an OSC here, so it ends just like the others
+        p.osc_end(true);
+        tgt = state::sos_pm_apc_string;
+        break;
+    default:
+        // Limits are only counted within a sequence
+        // Should that ever not hold, drop whatever is left and start over
+        VTDEC_ASSERT(!"illegal sequence");
+        tgt = state::ground;
+        break;
+    }
+
+    if constexpr (processor_traits<std::decay_t<Processor>>::wants_trace)
+    {
+        p.decode_transition(s.state, tgt);
+    }
+
+    s.state = tgt;
+    s.sequence = sequence::idk;
+}
+
+/**
+ * Internal. Count a codepoint against the limit for the current sequence. If
+ * it would go over, the sequence is truncated instead.
+ *
+ * @return True if the codepoint may be passed along, otherwise false
+ */
+template<class Processor>
+bool take(Processor&& p, decode_state& s, std::size_t limit)
+{
+    if (s.length < limit)
+    {
+        ++s.length;
+        return true;
+    }
+
+    truncate(p, s);
+    return false;
+}
+
+/**
+ * Internal. Count a run of codepoints against the limit for the current
+ * sequence, as take would for each in turn.
+ *
+ * @return The number of codepoints at the front of the run that may be passed
+ * along. If this falls short, the sequence must be truncated after them.
+ */
+inline std::size_t take_run(decode_state& s, std::size_t limit, std::size_t n)
 {
-    p.decode_action(act);
+    auto room = limit - s.length;
+
+    if (n > room)
+    {
+        n = room;
+    }
+
+    s.length += n;
+    return n;
+}
+
+/**
+ * Internal. Carry out an action. The sequence is parsed from the GL
+ * counterpart of the table key, so it sees just what the table saw: a GR
+ * octet stands in for its GL counterpart, and a wide codepoint for a space.
+ */
+template<class Processor, class Config>
+void do_action(Processor&& p, decode_state& s, int act, unsigned char key, char32_t c, const Config& cfg)
+{
+    if constexpr (processor_traits<std::decay_t<Processor>>::wants_trace)
+    {
+        p.decode_action(act);
+    }
+
+    auto gl = static_cast<char>(key & 0x7f);
 
     // Perform the action
     switch (act)
@@ -87,9 +309,13 @@ static decode_state do_action(Processor&& p, decode_state s, int act, char c)
         break;
     case action::execute:
         // A single-codepoint control
-        p.ctl(c);
+        p.ctl(static_cast<char>(c));
         break;
     case action::clear:
+        // Forget any parameters
+        reset_params(s.csi);
+        s.length = 0;
+
         // Cancel the current sequence
         switch (s.sequence)
         {
@@ -106,7 +332,8 @@ static decode_state do_action(Processor&& p, decode_state s, int act, char c)
             p.osc_end(true);
             break;
         default:
-            throw std::runtime_error {"illegal sequence"};
+            VTDEC_ASSERT(!"illegal sequence");
+            break;
         }
 
         // This is our only chance to call the beginnings of certain sequences
@@ -137,12 +364,20 @@ static decode_state do_action(Processor&& p, decode_state s, int act, char c)
         case state::csi_intermediate:
         case state::csi_param:
             // Append to control sequence
-            p.ctl_put(c);
+            if (take(p, s, cfg.max_csi))
+            {
+                collect_param(s.csi, gl, s.state);
+                p.ctl_put(c);
+            }
             break;
         case state::dcs_intermediate:
         case state::dcs_param:
             // Append to device control sequence
-            p.dcs_put(c);
+            if (take(p, s, cfg.max_dcs))
+            {
+                collect_param(s.csi, gl, s.state);
+                p.dcs_put(c);
+            }
             break;
         case state::escape_intermediate:
             // Begin control sequence
@@ -150,25 +385,35 @@ static decode_state do_action(Processor&& p, decode_state s, int act, char c)
             s.sequence = sequence::ctl;
             break;
         default:
-            throw std::runtime_error {"illegal state"};
+            // Ruled out by table_check_actions
+            VTDEC_ASSERT(!"illegal state");
+            break;
         }
         break;
     case action::param:
         // Append to appropriate sequence
-        switch (s.sequence)
+        switch (s.state)
         {
-        case sequence::ctl:
+        case state::csi_param:
             // Append to control sequence
-            p.ctl_put(c);
+            if (take(p, s, cfg.max_csi))
+            {
+                accumulate_param(s.csi, gl);
+                p.ctl_put(c);
+            }
             break;
-        case sequence::dcs:
+        case state::dcs_param:
             // Append to device control sequence
-            p.dcs_put(c);
+            if (take(p, s, cfg.max_dcs))
+            {
+                accumulate_param(s.csi, gl);
+                p.dcs_put(c);
+            }
             break;
-        case sequence::idk:
-        case sequence::osc:
         default:
-            throw std::runtime_error {"illegal sequence"};
+            // Ruled out by table_check_actions
+            VTDEC_ASSERT(!"illegal state");
+            break;
         }
         break;
     case action::esc_dispatch:
@@ -177,14 +422,25 @@ static decode_state do_action(Processor&& p, decode_state s, int act, char c)
         s.sequence = sequence::idk;
         break;
     case action::csi_dispatch:
-        // End control sequence
+        // Dispatch and end control sequence
+        p.csi_dispatch(s.csi, gl);
         p.ctl_end(false);
         s.sequence = sequence::idk;
         break;
     case action::hook:
+        // Hand over the parsed sequence, then append the final character
+        if (take(p, s, cfg.max_dcs))
+        {
+            p.dcs_hook(s.csi, gl);
+            p.dcs_put(c);
+        }
+        break;
     case action::put:
         // Append to device control sequence
-        p.dcs_put(c);
+        if (take(p, s, cfg.max_dcs))
+        {
+            p.dcs_put(c);
+        }
         break;
     case action::unhook:
         // End device control string
@@ -195,10 +451,14 @@ static decode_state do_action(Processor&& p, decode_state s, int act, char c)
         // Begin operating system command
         p.osc_begin();
         s.sequence = sequence::osc;
+        s.length = 0;
         break;
     case action::osc_put:
         // Continue operating system command
-        p.osc_put(c);
+        if (take(p, s, cfg.max_osc))
+        {
+            p.osc_put(c);
+        }
         break;
     case action::osc_end:
         // End operating system command
@@ -206,189 +466,608 @@ static decode_state do_action(Processor&& p, decode_state s, int act, char c)
         s.sequence = sequence::idk;
         break;
     }
-
-    return s;
 }
 
 /**
  * Internal. Carry out a transition.
  */
-template<class Processor>
-static decode_state do_transition(Processor&& p, decode_state s, int tgt, char c)
+template<class Processor, class Config>
+void do_transition(Processor&& p, decode_state& s, int tgt, unsigned char key, char32_t c, const Config& cfg)
 {
-    p.decode_transition(s.state, tgt);
+    if constexpr (processor_traits<std::decay_t<Processor>>::wants_trace)
+    {
+        p.decode_transition(s.state, tgt);
+    }
 
     // Look up predicate for leaving current state
-    auto& pred_leave = table[s.state][129];
+    auto& pred_leave = table_events[s.state].leave;
 
     // Do leave action if one is to be taken
     if (pred_leave.action > action::none)
     {
-        s = do_action(p, s, pred_leave.action, c);
+        do_action(p, s, pred_leave.action, key, c, cfg);
     }
 
     // Make the transition
     s.state = tgt;
 
     // Look up predicate for entering target state
-    auto& pred_enter = table[s.state][128];
+    auto& pred_enter = table_events[s.state].enter;
 
     // Do enter action if one is to be taken
     if (pred_enter.action > action::none)
     {
-        s = do_action(p, s, pred_enter.action, c);
+        do_action(p, s, pred_enter.action, key, c, cfg);
     }
-
-    return s;
 }
 
 /**
- * Internal. Unchecked put of a single-octet codepoint.
+ * Internal. Carry out a fused table entry. The entry is known at compile
+ * time, so each micro-operation folds down to just the code it needs.
  */
-template<class Processor>
-decode_state put(char c, Processor&& p, decode_state s)
+template<std::size_t Op, class Processor, class Config>
+void do_fused(Processor& p, decode_state& s, unsigned char key, char32_t c, const Config& cfg)
 {
-    // Look up predicate for this codepoint in this state
-    auto& pred = table[s.state][c];
+    constexpr auto op = table_fused_ops[Op];
 
     // Do transition if one is to be made
-    if (pred.target > state::none)
+    if constexpr (op.target() > state::none)
     {
-        s = do_transition(p, s, pred.target, c);
+        if constexpr (processor_traits<Processor>::wants_trace)
+        {
+            p.decode_transition(s.state, op.target());
+        }
+
+        // Do leave action if one is to be taken
+        if constexpr (op.leave() > action::none)
+        {
+            do_action(p, s, op.leave(), key, c, cfg);
+        }
+
+        // Make the transition
+        s.state = op.target();
+
+        // Do enter action if one is to be taken
+        if constexpr (op.enter() > action::none)
+        {
+            do_action(p, s, op.enter(), key, c, cfg);
+        }
     }
 
     // Do action if one is to be taken
-    if (pred.action > action::none)
+    if constexpr (op.action() > action::none)
     {
-        s = do_action(p, s, pred.action, c);
+        do_action(p, s, op.action(), key, c, cfg);
     }
+}
 
-    return s;
+/**
+ * Internal. Build the jump table over fused table entries.
+ */
+template<class Processor, class Config, std::size_t... Op>
+constexpr auto make_fused_dispatch(std::index_sequence<Op...>)
+{
+    using handler = void (*)(Processor&, decode_state&, unsigned char, char32_t, const Config&);
+    return std::array<handler, sizeof...(Op)> {&do_fused<Op, Processor, Config>...};
 }
 
 /**
- * Internal. Unchecked put of a single-octet codepoint. Overload alias for put.
+ * Internal. The jump table over fused table entries.
  */
-template<class Processor>
-decode_state put_one(char c, Processor&& p, decode_state s)
+template<class Processor, class Config>
+inline constexpr auto fused_dispatch =
+        make_fused_dispatch<Processor, Config>(std::make_index_sequence<table_fused_op_count>());
+
+/**
+ * Internal. Unchecked put of a codepoint. The table is consulted for a
+ * single-octet key, which stands in for the codepoint, while the codepoint
+ * itself is what reaches the processor.
+ */
+template<class Processor, class Config>
+void put(unsigned char key, char32_t c, Processor&& p, decode_state& s, const Config& cfg)
 {
-    p.decode_put(c);
-    return put(c, p, s);
+    using table_backend = typename processor_traits<std::decay_t<Processor>>::table_backend;
+
+    if constexpr (std::is_same_v<table_backend, table_backend_fused>)
+    {
+        // Look up every micro-operation for this key in this state at once
+        // They happen in the same order as with the other backends, behind one dispatch
+        auto op = table_backend::lookup(s.state, key);
+
+        fused_dispatch<std::decay_t<Processor>, Config>[op](p, s, key, c, cfg);
+    }
+    else
+    {
+        // Look up predicate for this key in this state
+        auto pred = table_backend::lookup(s.state, key);
+
+        // Do transition if one is to be made
+        if (pred.target > state::none)
+        {
+            do_transition(p, s, pred.target, key, c, cfg);
+        }
+
+        // Do action if one is to be taken
+        if (pred.action > action::none)
+        {
+            do_action(p, s, pred.action, key, c, cfg);
+        }
+    }
+}
+
+/**
+ * Internal. Unchecked put of a single-octet codepoint.
+ */
+template<class Processor, class Config>
+void put_one(char c, Processor&& p, decode_state& s, const Config& cfg)
+{
+    if constexpr (processor_traits<std::decay_t<Processor>>::wants_trace)
+    {
+        p.decode_put(static_cast<unsigned char>(c));
+    }
+
+    auto key = static_cast<unsigned char>(c);
+
+    put(key, key, p, s, cfg);
 }
 
 /**
  * Internal. Unchecked put of a 32-bit codepoint.
  */
+template<class Processor, class Config>
+void put_one(char32_t c, Processor&& p, decode_state& s, const Config& cfg)
+{
+    if constexpr (processor_traits<std::decay_t<Processor>>::wants_trace)
+    {
+        p.decode_put(c);
+    }
+
+    // The C0 and C1 controls and ASCII take their own columns
+    // A graphic codepoint beyond these is not an active codepoint (i.e. it
+    // cannot trigger a transition), so it takes the column of the space
+    // character. That way, it prints in the ground state and is collected in
+    // strings.
+    auto key = static_cast<unsigned char>(c < 0xa0 ? c : ' ');
+
+    put(key, c, p, s, cfg);
+}
+
+/**
+ * Internal. Unchecked put over a range of character things.
+ */
+template<class Processor, class InputIter, class Config>
+void put_range(InputIter begin, InputIter end, Processor&& p, decode_state& s, const Config& cfg)
+{
+    for (auto i = begin; i != end; ++i)
+    {
+        put_one(*i, p, s, cfg);
+    }
+}
+
+/**
+ * Internal. Whether a processor can take a run of printable codepoints.
+ */
+template<class Processor, class View, class = void>
+inline constexpr bool has_print_run_v = false;
+
+/**
+ * Internal. Whether a processor can take a run of printable codepoints.
+ */
+template<class Processor, class View>
+inline constexpr bool has_print_run_v<Processor, View,
+        std::void_t<decltype(std::declval<Processor&>().print_run(std::declval<View>()))>> = true;
+
+/**
+ * Internal. Whether a processor can take a run of OSC codepoints.
+ */
+template<class Processor, class = void>
+inline constexpr bool has_osc_data_v = false;
+
+/**
+ * Internal. Whether a processor can take a run of OSC codepoints.
+ */
 template<class Processor>
-decode_state put_one(char32_t c, Processor&& p, decode_state s)
+inline constexpr bool has_osc_data_v<Processor,
+        std::void_t<decltype(std::declval<Processor&>().osc_data(std::declval<std::string_view>()))>> = true;
+
+/**
+ * Internal. Whether a processor can take a run of DCS codepoints.
+ */
+template<class Processor, class = void>
+inline constexpr bool has_dcs_data_v = false;
+
+/**
+ * Internal. Whether a processor can take a run of DCS codepoints.
+ */
+template<class Processor>
+inline constexpr bool has_dcs_data_v<Processor,
+        std::void_t<decltype(std::declval<Processor&>().dcs_data(std::declval<std::string_view>()))>> = true;
+
+/**
+ * Internal. Test whether a 32-bit codepoint prints in the ground state.
+ */
+constexpr bool is_ground_print(char32_t c)
 {
-    p.decode_put(c);
+    return (0x20 <= c && c <= 0x7f) || 0xa0 <= c;
+}
 
-    // Get least significant byte of codepoint
-    // For all VT controls, we only care about this byte
-    auto lsb = static_cast<char>(c & 0xff);
+/**
+ * Internal. Pass through a run of printable codepoints.
+ */
+template<class Processor, class CharT>
+void print_run(Processor&& p, std::basic_string_view<CharT> run)
+{
+    if constexpr (has_print_run_v<Processor, std::basic_string_view<CharT>>)
+    {
+        p.print_run(run);
+    }
+    else
+    {
+        for (auto c : run)
+        {
+            p.print(static_cast<std::make_unsigned_t<CharT>>(c));
+        }
+    }
+}
 
-    // If the least significant byte equals the whole thing
-    if (lsb == c)
+/**
+ * Internal. Continue an operating system command with a run of codepoints.
+ * Runs of single-octet codepoints are passed along without a copy.
+ */
+template<class Processor, class CharT>
+void osc_run(Processor&& p, std::basic_string_view<CharT> run)
+{
+    if constexpr (std::is_same_v<CharT, char> && has_osc_data_v<Processor>)
     {
-        // The codepoint only occupies one octet
-        // So, we process it as a single-octet codepoint
-        s = put(lsb, p, s);
+        p.osc_data(run);
     }
     else
     {
-        // The codepoint occupies more than one octet
-        // This is not an active codepoint (i.e. it cannot trigger an action)
+        for (auto c : run)
+        {
+            p.osc_put(static_cast<std::make_unsigned_t<CharT>>(c));
+        }
+    }
+}
 
-        /**
-         * A special proxy processor for substituting printable characters in
-         * decode events. This is used for large (i.e. non-ASCII) codepoint
-         * support.
-         */
-        class substitutor : public processor
+/**
+ * Internal. Continue a device control string with a run of codepoints. Runs of
+ * single-octet codepoints are passed along without a copy.
+ */
+template<class Processor, class CharT>
+void dcs_run(Processor&& p, std::basic_string_view<CharT> run)
+{
+    if constexpr (std::is_same_v<CharT, char> && has_dcs_data_v<Processor>)
+    {
+        p.dcs_data(run);
+    }
+    else
+    {
+        for (auto c : run)
         {
-            /** The original processor. */
-            Processor&& m_proc;
+            p.dcs_put(static_cast<std::make_unsigned_t<CharT>>(c));
+        }
+    }
+}
 
-            /** The original printable codepoint. */
-            char32_t m_orig;
+/**
+ * Internal. Find the end of the run of codepoints at the front of a string
+ * that would each take the same plain, transition-free action in a state.
+ * Only the ground state is considered for 32-bit codepoints.
+ */
+inline std::size_t scan_run(std::string_view str, int state)
+{
+    switch (state)
+    {
+    case state::ground:
+    case state::osc_string:
+        return scan_text(str.data(), str.data() + str.size()) - str.data();
+    case state::dcs_passthrough:
+    case state::dcs_ignore:
+    case state::sos_pm_apc_string:
+        // These states take most C0 controls in stride, too
+        return scan_dcs(str.data(), str.data() + str.size()) - str.data();
+    default:
+        return 0;
+    }
+}
 
-        public:
-            substitutor(Processor&& p_proc, char32_t p_orig)
-                    : m_proc {p_proc}
-                    , m_orig {p_orig}
-            {
-            }
+/**
+ * Internal. Find the end of the run of codepoints at the front of a string
+ * that would each take the same plain, transition-free action in a state.
+ * Only the ground state is considered for 32-bit codepoints.
+ */
+inline std::size_t scan_run(std::u32string_view str, int state)
+{
+    std::size_t i = 0;
 
-            void print(char32_t) final
-            { m_proc.passthrough(m_orig); }
+    if (state == state::ground)
+    {
+        while (i < str.size() && is_ground_print(str[i]))
+        {
+            ++i;
+        }
+    }
 
-            void ctl(char c) final
-            { m_proc.ctl_put(c); }
+    return i;
+}
 
-            void ctl_begin() final
-            { m_proc.ctl_begin(); }
+/**
+ * Internal. Carry out the action for a run found by scan_run.
+ */
+template<class Processor, class CharT, class Config>
+void do_run(Processor&& p, decode_state& s, std::basic_string_view<CharT> run, const Config& cfg)
+{
+    switch (s.state)
+    {
+    case state::ground:
+        print_run(p, run);
+        break;
+    case state::osc_string:
+    {
+        // Whatever is past the limit is ignored after truncation
+        auto n = take_run(s, cfg.max_osc, run.size());
+        if (n != 0)
+        {
+            osc_run(p, run.substr(0, n));
+        }
+        if (n < run.size())
+        {
+            truncate(p, s);
+        }
+        break;
+    }
+    case state::dcs_passthrough:
+    {
+        // Whatever is past the limit is ignored after truncation
+        auto n = take_run(s, cfg.max_dcs, run.size());
+        if (n != 0)
+        {
+            dcs_run(p, run.substr(0, n));
+        }
+        if (n < run.size())
+        {
+            truncate(p, s);
+        }
+        break;
+    }
+    default:
+        // The run is ignored
+        break;
+    }
+}
 
-            void ctl_put(char32_t) final
-            { m_proc.ctl_put(m_orig); }
+/**
+ * Internal. Unchecked put of a string of codepoints.
+ *
+ * Runs of plain codepoints in the ground state and in the string states skip
+ * the table and go straight to the processor. Tracing needs every codepoint to
+ * pass through the table, however, so it disables the fast path.
+ */
+template<class Processor, class CharT, class Config>
+void put_string(std::basic_string_view<CharT> str, Processor&& p, decode_state& s, const Config& cfg)
+{
+    if constexpr (processor_traits<std::decay_t<Processor>>::wants_trace)
+    {
+        put_range(str.begin(), str.end(), p, s, cfg);
+    }
+    else
+    {
+        std::size_t i = 0;
 
-            void ctl_end(bool cancel) final
-            { m_proc.ctl_end(cancel); }
+        while (i < str.size())
+        {
+            // Scan ahead to the next codepoint that needs the table
+            auto n = scan_run(str.substr(i), s.state);
 
-            void dcs_begin() final
-            { m_proc.dcs_begin(); }
+            if (n != 0)
+            {
+                do_run(p, s, str.substr(i, n), cfg);
+                i += n;
+
+                // The run may have taken the rest of the string
+                if (i == str.size())
+                {
+                    break;
+                }
+            }
 
-            void dcs_put(char32_t) final
-            { m_proc.dcs_put(m_orig); }
+            put_one(str[i++], p, s, cfg);
+        }
+    }
+}
 
-            void dcs_end(bool cancel) final
-            { m_proc.dcs_end(cancel); }
+/**
+ * Internal. Whether an octet continues the UTF-8 sequence in progress. The
+ * second octet is held to a narrower range after some leads, so that no
+ * overlong form, surrogate, or codepoint beyond Unicode gets past it.
+ */
+inline bool utf8_continues(const decode_state& s, unsigned char c)
+{
+    unsigned char lo = 0x80;
+    unsigned char hi = 0xbf;
 
-            void osc_begin() final
-            { m_proc.osc_begin(); }
+    if (s.utf8_remaining == s.utf8_length - 1)
+    {
+        // The lead's payload bits tell E0, ED, F0, and F4 apart
+        if (s.utf8_length == 3 && s.utf8_codepoint == 0x0)
+        {
+            lo = 0xa0;
+        }
+        else if (s.utf8_length == 3 && s.utf8_codepoint == 0xd)
+        {
+            hi = 0x9f;
+        }
+        else if (s.utf8_length == 4 && s.utf8_codepoint == 0x0)
+        {
+            lo = 0x90;
+        }
+        else if (s.utf8_length == 4 && s.utf8_codepoint == 0x4)
+        {
+            hi = 0x8f;
+        }
+    }
 
-            void osc_put(char32_t) final
-            { m_proc.osc_put(m_orig); }
+    return lo <= c && c <= hi;
+}
 
-            void osc_end(bool cancel) final
-            { m_proc.osc_end(cancel); }
+/**
+ * Internal. Unchecked put of a string of UTF-8 code units.
+ *
+ * Octets below 0x80 outside of a UTF-8 sequence are put straight through as
+ * single-octet codepoints, taking the same fast path as put_string. Everything
+ * else is assembled into 32-bit codepoints. Malformed input puts U+FFFD in
+ * place of each maximal subpart, as Unicode recommends: a sequence is given up
+ * at the first octet that cannot continue it, and that octet starts afresh.
+ * Overlong forms, surrogates, and codepoints beyond Unicode are all caught at
+ * the second octet this way. A sequence left incomplete at the end of the
+ * string resumes with the next call.
+ */
+template<class Processor, class Config>
+void put_utf8(std::string_view str, Processor&& p, decode_state& s, const Config& cfg)
+{
+    std::size_t i = 0;
 
-            void decode_begin() final
-            { m_proc.decode_begin(); }
+    while (i < str.size())
+    {
+        if constexpr (!processor_traits<std::decay_t<Processor>>::wants_trace)
+        {
+            if (s.utf8_remaining == 0)
+            {
+                // Scan ahead to the next octet that needs the table or the UTF-8 decoder
+                auto n = scan_run(str.substr(i), s.state);
+
+                if (n != 0)
+                {
+                    do_run(p, s, str.substr(i, n), cfg);
+                    i += n;
+
+                    // The run may have taken the rest of the string
+                    if (i == str.size())
+                    {
+                        break;
+                    }
+                }
+            }
+        }
 
-            void decode_put(char32_t) final
-            { m_proc.decode_put(m_orig); }
+        auto c = static_cast<unsigned char>(str[i]);
 
-            void decode_action(int act) final
-            { m_proc.decode_action(act); }
+        if (s.utf8_remaining == 0)
+        {
+            if (c < 0x80)
+            {
+                // Single-octet codepoint
+                put_one(static_cast<char>(c), p, s, cfg);
+            }
+            else if (0xc2 <= c && c <= 0xdf)
+            {
+                // Lead of a two-octet sequence
+                s.utf8_codepoint = c & 0x1f;
+                s.utf8_remaining = 1;
+                s.utf8_length = 2;
+            }
+            else if (0xe0 <= c && c <= 0xef)
+            {
+                // Lead of a three-octet sequence
+                s.utf8_codepoint = c & 0x0f;
+                s.utf8_remaining = 2;
+                s.utf8_length = 3;
+            }
+            else if (0xf0 <= c && c <= 0xf4)
+            {
+                // Lead of a four-octet sequence
+                s.utf8_codepoint = c & 0x07;
+                s.utf8_remaining = 3;
+                s.utf8_length = 4;
+            }
+            else
+            {
+                // Stray continuation or invalid lead
+                put_one(U'\ufffd', p, s, cfg);
+            }
 
-            void decode_transition(int src, int dst) final
-            { m_proc.decode_transition(src, dst); }
+            ++i;
+        }
+        else if (utf8_continues(s, c))
+        {
+            // Continuation of the current sequence
+            s.utf8_codepoint = (s.utf8_codepoint << 6) | (c & 0x3f);
 
-            void decode_end(bool cancel) final
-            { m_proc.decode_end(cancel); }
-        };
+            if (--s.utf8_remaining == 0)
+            {
+                put_one(s.utf8_codepoint, p, s, cfg);
+            }
 
-        // Pass the large codepoint off as a space character and proxy the results
-        // This takes care of all printable codepoints more complicated than ASCII
-        s = put(' ', substitutor {p, c}, s);
+            ++i;
+        }
+        else
+        {
+            // The sequence was cut short, so the octet starts afresh on the next pass
+            s.utf8_remaining = 0;
+            put_one(U'\ufffd', p, s, cfg);
+        }
     }
-
-    return s;
 }
 
 /**
- * Internal. Unchecked put over a range of character things.
+ * Internal. Unchecked end of the stream. A partial UTF-8 sequence puts U+FFFD
+ * in its place. Then, any unfinished sequence is canceled, and the decoder
+ * goes back to the ground state.
  */
-template<class Processor, class InputIter>
-decode_state put_range(InputIter begin, InputIter end, Processor&& p, decode_state s)
+template<class Processor, class Config>
+void put_end(Processor&& p, decode_state& s, const Config& cfg)
 {
-    for (auto i = begin; i != end; ++i)
+    if (s.utf8_remaining != 0)
     {
-        s = put_one(*i, p, s);
+        s.utf8_remaining = 0;
+        put_one(U'\ufffd', p, s, cfg);
     }
 
-    return s;
+    switch (s.sequence)
+    {
+    case sequence::ctl:
+        p.ctl_end(true);
+        break;
+    case sequence::dcs:
+        p.dcs_end(true);
+        break;
+    case sequence::osc:
+        p.osc_end(true);
+        break;
+    default:
+        // No sequence to cancel
+        break;
+    }
+
+    if (s.state != state::ground)
+    {
+        if constexpr (processor_traits<std::decay_t<Processor>>::wants_trace)
+        {
+            p.decode_transition(s.state, state::ground);
+        }
+
+        s.state = state::ground;
+    }
+
+    s.sequence = sequence::idk;
+}
+
+/**
+ * Internal. Get a statically-dispatched view of a processor. Static processors
+ * are used as-is, while virtual processors are wrapped in an adapter.
+ */
+template<class Processor>
+decltype(auto) dispatch(Processor& p)
+{
+    if constexpr (is_static_processor_v<std::remove_cv_t<Processor>>)
+    {
+        return (p);
+    }
+    else
+    {
+        return processor_adapter<Processor> {p};
+    }
 }
 
 } // namespace detail
@@ -400,16 +1079,20 @@ decode_state put_range(InputIter begin, InputIter end, Processor&& p, decode_sta
  * @param c The codepoint
  * @param proc The target processor (optional)
  * @param state An initial state (optional)
+ * @param config Limits on the sequences (optional)
  * @return The residual state
  */
-template<class Processor>
-decode_state decode(char c, Processor&& proc = {}, decode_state state = {})
+template<class Processor, class Config = decode_config>
+decode_state decode(char c, Processor&& proc = {}, decode_state state = {},
+        const Config& config = {}) noexcept(processor_traits<std::decay_t<Processor>>::nothrow)
 {
-    static_assert(std::is_base_of_v<processor, std::decay_t<Processor>>, "parameter 'proc' not a vtdec::processor");
+    static_assert(is_processor_v<std::decay_t<Processor>>, "parameter 'proc' not a vtdec::processor");
+
+    auto&& p = detail::dispatch(proc);
 
-    proc.decode_begin();
-    state = detail::put_one(c, proc, state);
-    proc.decode_end(false);
+    p.decode_begin();
+    detail::put_one(c, p, state, config);
+    p.decode_end(false);
 
     return state;
 }
@@ -421,16 +1104,20 @@ decode_state decode(char c, Processor&& proc = {}, decode_state state = {})
  * @param c The codepoint
  * @param proc The target processor (optional)
  * @param state An initial state (optional)
+ * @param config Limits on the sequences (optional)
  * @return The residual state
  */
-template<class Processor>
-decode_state decode(char32_t c, Processor&& proc = {}, decode_state state = {})
+template<class Processor, class Config = decode_config>
+decode_state decode(char32_t c, Processor&& proc = {}, decode_state state = {},
+        const Config& config = {}) noexcept(processor_traits<std::decay_t<Processor>>::nothrow)
 {
-    static_assert(std::is_base_of_v<processor, std::decay_t<Processor>>, "parameter 'proc' not a vtdec::processor");
+    static_assert(is_processor_v<std::decay_t<Processor>>, "parameter 'proc' not a vtdec::processor");
 
-    proc.decode_begin();
-    state = detail::put_one(c, proc, state);
-    proc.decode_end(false);
+    auto&& p = detail::dispatch(proc);
+
+    p.decode_begin();
+    detail::put_one(c, p, state, config);
+    p.decode_end(false);
 
     return state;
 }
@@ -447,16 +1134,21 @@ decode_state decode(char32_t c, Processor&& proc = {}, decode_state state = {})
  * @param end An iterator one past the end of the codepoint collection
  * @param proc The target processor (optional)
  * @param state An initial state (optional)
+ * @param config Limits on the sequences (optional)
  * @return The residual state
  */
-template<class Processor, class InputIter>
-decode_state decode(InputIter begin, InputIter end, Processor&& proc = {}, decode_state state = {})
+template<class Processor, class InputIter, class Config = decode_config>
+decode_state decode(InputIter begin, InputIter end, Processor&& proc = {}, decode_state state = {},
+        const Config& config = {}) noexcept(processor_traits<std::decay_t<Processor>>::nothrow
+        && noexcept(begin != end) && noexcept(*++begin))
 {
-    static_assert(std::is_base_of_v<processor, std::decay_t<Processor>>, "parameter 'proc' not a vtdec::processor");
+    static_assert(is_processor_v<std::decay_t<Processor>>, "parameter 'proc' not a vtdec::processor");
+
+    auto&& p = detail::dispatch(proc);
 
-    proc.decode_begin();
-    state = detail::put_range(begin, end, proc, state);
-    proc.decode_end(false);
+    p.decode_begin();
+    detail::put_range(begin, end, p, state, config);
+    p.decode_end(false);
 
     return state;
 }
@@ -468,16 +1160,20 @@ decode_state decode(InputIter begin, InputIter end, Processor&& proc = {}, decod
  * @param str A view of the input string
  * @param proc The target processor (optional)
  * @param state An initial state (optional)
+ * @param config Limits on the sequences (optional)
  * @return The residual state
  */
-template<class Processor>
-decode_state decode(std::string_view str, Processor&& proc = {}, decode_state state = {})
+template<class Processor, class Config = decode_config>
+decode_state decode(std::string_view str, Processor&& proc = {}, decode_state state = {},
+        const Config& config = {}) noexcept(processor_traits<std::decay_t<Processor>>::nothrow)
 {
-    static_assert(std::is_base_of_v<processor, std::decay_t<Processor>>, "parameter 'proc' not a vtdec::processor");
+    static_assert(is_processor_v<std::decay_t<Processor>>, "parameter 'proc' not a vtdec::processor");
 
-    proc.decode_begin();
-    state = detail::put_range(str.begin(), str.end(), proc, state);
-    proc.decode_end(false);
+    auto&& p = detail::dispatch(proc);
+
+    p.decode_begin();
+    detail::put_string(str, p, state, config);
+    p.decode_end(false);
 
     return state;
 }
@@ -489,16 +1185,74 @@ decode_state decode(std::string_view str, Processor&& proc = {}, decode_state st
  * @param str A view of the input string
  * @param proc The target processor (optional)
  * @param state An initial state (optional)
+ * @param config Limits on the sequences (optional)
  * @return The residual state
  */
-template<class Processor>
-decode_state decode(std::u32string_view str, Processor&& proc = {}, decode_state state = {})
+template<class Processor, class Config = decode_config>
+decode_state decode(std::u32string_view str, Processor&& proc = {}, decode_state state = {},
+        const Config& config = {}) noexcept(processor_traits<std::decay_t<Processor>>::nothrow)
 {
-    static_assert(std::is_base_of_v<processor, std::decay_t<Processor>>, "parameter 'proc' not a vtdec::processor");
+    static_assert(is_processor_v<std::decay_t<Processor>>, "parameter 'proc' not a vtdec::processor");
+
+    auto&& p = detail::dispatch(proc);
+
+    p.decode_begin();
+    detail::put_string(str, p, state, config);
+    p.decode_end(false);
+
+    return state;
+}
+
+/**
+ * Decode a string of UTF-8 input code units.
+ *
+ * A multi-octet sequence split across calls is resumed from the given state,
+ * so input may be decoded straight from each read without transcoding it.
+ *
+ * @tparam Processor The processor type
+ * @param str A view of the input string
+ * @param proc The target processor (optional)
+ * @param state An initial state (optional)
+ * @param config Limits on the sequences (optional)
+ * @return The residual state
+ */
+template<class Processor, class Config = decode_config>
+decode_state decode_utf8(std::string_view str, Processor&& proc = {}, decode_state state = {},
+        const Config& config = {}) noexcept(processor_traits<std::decay_t<Processor>>::nothrow)
+{
+    static_assert(is_processor_v<std::decay_t<Processor>>, "parameter 'proc' not a vtdec::processor");
+
+    auto&& p = detail::dispatch(proc);
+
+    p.decode_begin();
+    detail::put_utf8(str, p, state, config);
+    p.decode_end(false);
+
+    return state;
+}
+
+/**
+ * Flush the end of a stream of input. A partial UTF-8 sequence is decoded as
+ * U+FFFD. Then, any unfinished sequence is canceled, and the decoder goes back
+ * to the ground state.
+ *
+ * @tparam Processor The processor type
+ * @param proc The target processor
+ * @param state The residual state of the stream
+ * @param config Limits on the sequences (optional)
+ * @return The state for a new stream
+ */
+template<class Processor, class Config = decode_config>
+decode_state flush(Processor&& proc, decode_state state, const Config& config = {})
+        noexcept(processor_traits<std::decay_t<Processor>>::nothrow)
+{
+    static_assert(is_processor_v<std::decay_t<Processor>>, "parameter 'proc' not a vtdec::processor");
+
+    auto&& p = detail::dispatch(proc);
 
-    proc.decode_begin();
-    state = detail::put_range(str.begin(), str.end(), proc, state);
-    proc.decode_end(false);
+    p.decode_begin();
+    detail::put_end(p, state, config);
+    p.decode_end(false);
 
     return state;
 }
@@ -0,0 +1,198 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+#ifndef VTDEC_DECODER_H
+#define VTDEC_DECODER_H
+
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version>
+#endif
+#endif
+
+#if defined(__cpp_lib_span)
+#include <span>
+#endif
+
+#include <vtdec/decode.h>
+
+namespace vtdec
+{
+
+/**
+ * A decoder bound to a processor for the life of a stream. It owns all the
+ * state carried from one chunk of input to the next, including any partial
+ * UTF-8 sequence and the parameters of any unfinished control sequence, so
+ * input may be fed in chunks of any size as it arrives.
+ *
+ * However the input is split, the processor sees the same callbacks, with
+ * decode_begin and decode_end coming once each. A run may be split into more
+ * than one, but the codepoints in the runs stay the same. So a processor that
+ * takes one codepoint at a time sees exactly the same thing.
+ *
+ * A decoder holds no resources and is trivially copyable, so many of them may
+ * be kept in a flat array and moved around with memcpy. The processor is not
+ * owned, and it must outlive the decoder.
+ *
+ * @tparam Processor The processor type
+ * @tparam Config The config type (optional)
+ */
+template<class Processor, class Config = decode_config>
+class decoder : private Config
+{
+    static_assert(is_processor_v<std::remove_cv_t<Processor>>, "parameter 'Processor' not a vtdec::processor");
+
+    /** The bound processor. */
+    Processor* m_proc;
+
+    /** The state carried between chunks. */
+    decode_state m_state;
+
+    /** True if the processor has been told a decode operation began, otherwise false. */
+    bool m_begun;
+
+public:
+    /**
+     * Bind a decoder to a processor.
+     *
+     * @param p_proc The processor
+     * @param p_config The config (optional)
+     */
+    explicit decoder(Processor& p_proc, const Config& p_config = {})
+            : Config {p_config}
+            , m_proc {&p_proc}
+            , m_state {}
+            , m_begun {false}
+    {
+        static_assert(std::is_trivially_copyable_v<decoder>, "decoder not trivially copyable");
+    }
+
+    /**
+     * @return The target processor
+     */
+    Processor& target() const
+    { return *m_proc; }
+
+    /**
+     * @return The config
+     */
+    const Config& config() const
+    { return *this; }
+
+    /**
+     * @return The state carried between chunks
+     */
+    const decode_state& state() const
+    { return m_state; }
+
+    /**
+     * Feed a chunk of UTF-8 input to the processor. The processor is told a
+     * decode operation began on the first chunk.
+     *
+     * @param str A view of the chunk
+     */
+    void feed(std::string_view str) noexcept(processor_traits<std::remove_cv_t<Processor>>::nothrow)
+    {
+        auto&& p = detail::dispatch(*m_proc);
+
+        if (!m_begun)
+        {
+            p.decode_begin();
+            m_begun = true;
+        }
+
+        detail::put_utf8(str, p, m_state, config());
+    }
+
+    /**
+     * Feed a chunk of UTF-8 input to the processor.
+     *
+     * @param data A pointer to the chunk
+     * @param size The size of the chunk in bytes
+     */
+    void feed(const std::byte* data, std::size_t size) noexcept(processor_traits<std::remove_cv_t<Processor>>::nothrow)
+    { feed(std::string_view {reinterpret_cast<const char*>(data), size}); }
+
+#if defined(__cpp_lib_span)
+
+    /**
+     * Feed a chunk of UTF-8 input to the processor.
+     *
+     * @param data A view of the chunk
+     */
+    void feed(std::span<const std::byte> data) noexcept(processor_traits<std::remove_cv_t<Processor>>::nothrow)
+    { feed(data.data(), data.size()); }
+
+#endif
+
+    /**
+     * Flush the end of the stream and finish. A partial UTF-8 sequence is
+     * decoded as U+FFFD. Then, any unfinished sequence is canceled, and the
+     * decoder goes back to the ground state, ready for a new stream.
+     */
+    void flush() noexcept(processor_traits<std::remove_cv_t<Processor>>::nothrow)
+    {
+        // A sequence may outlive its states, as an ignored one is not ended until the next begins
+        if (m_state.utf8_remaining != 0 || m_state.state != vtdec::state::ground
+                || m_state.sequence != detail::sequence::idk)
+        {
+            auto&& p = detail::dispatch(*m_proc);
+
+            if (!m_begun)
+            {
+                p.decode_begin();
+                m_begun = true;
+            }
+
+            detail::put_end(p, m_state, config());
+        }
+
+        finish();
+    }
+
+    /**
+     * Finish the current decode operation, if one began. The processor is
+     * told it ended. Any unfinished sequence is left as it is, so feeding may
+     * resume afterward.
+     */
+    void finish() noexcept(processor_traits<std::remove_cv_t<Processor>>::nothrow)
+    {
+        if (m_begun)
+        {
+            detail::dispatch(*m_proc).decode_end(false);
+            m_begun = false;
+        }
+    }
+};
+
+} // namespace vtdec
+
+#endif // #ifndef VTDEC_DECODER_H
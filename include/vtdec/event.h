@@ -0,0 +1,400 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+#ifndef VTDEC_EVENT_H
+#define VTDEC_EVENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+#include <vtdec/decode.h>
+#include <vtdec/processor.h>
+#include <vtdec/sequence.h>
+
+namespace vtdec
+{
+
+/**
+ * Event kind indices. Each is named for the processor hook it stands for.
+ */
+namespace event_kind
+{
+
+enum : std::uint8_t
+{
+    print,
+    print_run,
+    ctl,
+    ctl_begin,
+    ctl_put,
+    csi_dispatch,
+    ctl_end,
+    dcs_begin,
+    dcs_hook,
+    dcs_put,
+    dcs_data,
+    dcs_end,
+    osc_begin,
+    osc_put,
+    osc_data,
+    osc_end,
+};
+
+} // namespace event_kind
+
+/**
+ * A record of one processor callback. Records are plain old data, so they
+ * may be copied around in bulk and handed to another thread.
+ */
+struct event
+{
+    /** The event kind index. */
+    std::uint8_t kind;
+
+    /** The control or final character, or true on cancellation. */
+    std::uint8_t flag;
+
+    /** The codepoint, the size of the run, or the index of the parsed sequence. */
+    std::uint32_t value;
+
+    /** The run, if any. This points straight into the input. */
+    const char* data;
+
+    /**
+     * @return The run
+     */
+    constexpr std::string_view run() const
+    { return {data, value}; }
+};
+
+static_assert(std::is_trivially_copyable_v<event>, "event not trivially copyable");
+
+/**
+ * Caller-provided storage for event records and the parsed sequences they
+ * refer to. Nothing is allocated. The records are drained between calls to
+ * decode_events, e.g. with replay, and then the arena is cleared.
+ */
+struct event_arena
+{
+    /**
+     * The most records one octet of input may produce. One codepoint yields
+     * at most a leave action, an enter action, and an action, which together
+     * make five callbacks. An octet that cuts a UTF-8 sequence short also puts
+     * U+FFFD before itself.
+     */
+    static constexpr std::size_t max_events_per_octet = 10;
+
+    /** The event record storage. */
+    event* events;
+
+    /** The number of event records that fit. */
+    std::size_t event_capacity;
+
+    /** The number of event records written. */
+    std::size_t event_count;
+
+    /** The parsed sequence storage. At most one is written per octet. */
+    csi_sequence* sequences;
+
+    /** The number of parsed sequences that fit. */
+    std::size_t sequence_capacity;
+
+    /** The number of parsed sequences written. */
+    std::size_t sequence_count;
+
+    /**
+     * Forget all records and sequences.
+     */
+    void clear()
+    {
+        event_count = 0;
+        sequence_count = 0;
+    }
+};
+
+/**
+ * Implementation details.
+ */
+namespace detail
+{
+
+/**
+ * Internal. A processor that writes event records into an arena. The caller
+ * makes sure there is room.
+ */
+class event_writer : public static_processor<event_writer>
+{
+    /** The target arena. */
+    event_arena& m_arena;
+
+    void add(std::uint8_t kind, std::uint32_t value = 0, std::uint8_t flag = 0, const char* data = nullptr) noexcept
+    { m_arena.events[m_arena.event_count++] = event {kind, flag, value, data}; }
+
+    void add_sequence(std::uint8_t kind, const csi_sequence& seq, char final) noexcept
+    {
+        m_arena.sequences[m_arena.sequence_count] = seq;
+        add(kind, static_cast<std::uint32_t>(m_arena.sequence_count++), static_cast<std::uint8_t>(final));
+    }
+
+public:
+    static constexpr bool wants_trace = false;
+
+    explicit event_writer(event_arena& p_arena)
+            : m_arena {p_arena}
+    {
+    }
+
+    void print(char32_t c) noexcept
+    { add(event_kind::print, c); }
+
+    void print_run(std::string_view str) noexcept
+    { add(event_kind::print_run, static_cast<std::uint32_t>(str.size()), 0, str.data()); }
+
+    void ctl(char c) noexcept
+    { add(event_kind::ctl, 0, static_cast<std::uint8_t>(c)); }
+
+    void ctl_begin() noexcept
+    { add(event_kind::ctl_begin); }
+
+    void ctl_put(char32_t c) noexcept
+    { add(event_kind::ctl_put, c); }
+
+    void csi_dispatch(const csi_sequence& seq, char final) noexcept
+    { add_sequence(event_kind::csi_dispatch, seq, final); }
+
+    void ctl_end(bool cancel) noexcept
+    { add(event_kind::ctl_end, 0, cancel); }
+
+    void dcs_begin() noexcept
+    { add(event_kind::dcs_begin); }
+
+    void dcs_hook(const csi_sequence& seq, char final) noexcept
+    { add_sequence(event_kind::dcs_hook, seq, final); }
+
+    void dcs_put(char32_t c) noexcept
+    { add(event_kind::dcs_put, c); }
+
+    void dcs_data(std::string_view str) noexcept
+    { add(event_kind::dcs_data, static_cast<std::uint32_t>(str.size()), 0, str.data()); }
+
+    void dcs_end(bool cancel) noexcept
+    { add(event_kind::dcs_end, 0, cancel); }
+
+    void osc_begin() noexcept
+    { add(event_kind::osc_begin); }
+
+    void osc_put(char32_t c) noexcept
+    { add(event_kind::osc_put, c); }
+
+    void osc_data(std::string_view str) noexcept
+    { add(event_kind::osc_data, static_cast<std::uint32_t>(str.size()), 0, str.data()); }
+
+    void osc_end(bool cancel) noexcept
+    { add(event_kind::osc_end, 0, cancel); }
+};
+
+/**
+ * Internal. Put as much of a string as is sure to fit in an arena, a slice at
+ * a time, with the given put function.
+ *
+ * @return The number of octets put
+ */
+template<class PutFunction>
+std::size_t put_events(std::string_view str, event_arena& arena, PutFunction&& put)
+{
+    std::size_t done = 0;
+
+    while (done < str.size())
+    {
+        // Bound the slice by the worst case, so the arena cannot overflow
+        auto room = (arena.event_capacity - arena.event_count) / event_arena::max_events_per_octet;
+        auto seq_room = arena.sequence_capacity - arena.sequence_count;
+
+        if (room > seq_room)
+        {
+            room = seq_room;
+        }
+
+        if (room > str.size() - done)
+        {
+            room = str.size() - done;
+        }
+
+        if (room == 0)
+        {
+            break;
+        }
+
+        event_writer writer {arena};
+        put(str.substr(done, room), writer);
+        done += room;
+    }
+
+    return done;
+}
+
+/**
+ * Internal. Replay the event records in an arena on a dispatched processor,
+ * without telling it a decode operation began or ended.
+ */
+template<class Processor>
+void replay_events(const event_arena& arena, Processor&& p)
+{
+    for (std::size_t i = 0; i < arena.event_count; ++i)
+    {
+        auto& e = arena.events[i];
+
+        switch (e.kind)
+        {
+        case event_kind::print:
+            p.print(e.value);
+            break;
+        case event_kind::print_run:
+            detail::print_run(p, e.run());
+            break;
+        case event_kind::ctl:
+            p.ctl(static_cast<char>(e.flag));
+            break;
+        case event_kind::ctl_begin:
+            p.ctl_begin();
+            break;
+        case event_kind::ctl_put:
+            p.ctl_put(e.value);
+            break;
+        case event_kind::csi_dispatch:
+            p.csi_dispatch(arena.sequences[e.value], static_cast<char>(e.flag));
+            break;
+        case event_kind::ctl_end:
+            p.ctl_end(e.flag != 0);
+            break;
+        case event_kind::dcs_begin:
+            p.dcs_begin();
+            break;
+        case event_kind::dcs_hook:
+            p.dcs_hook(arena.sequences[e.value], static_cast<char>(e.flag));
+            break;
+        case event_kind::dcs_put:
+            p.dcs_put(e.value);
+            break;
+        case event_kind::dcs_data:
+            detail::dcs_run(p, e.run());
+            break;
+        case event_kind::dcs_end:
+            p.dcs_end(e.flag != 0);
+            break;
+        case event_kind::osc_begin:
+            p.osc_begin();
+            break;
+        case event_kind::osc_put:
+            p.osc_put(e.value);
+            break;
+        case event_kind::osc_data:
+            detail::osc_run(p, e.run());
+            break;
+        case event_kind::osc_end:
+            p.osc_end(e.flag != 0);
+            break;
+        default:
+            VTDEC_ASSERT(!"illegal event");
+            break;
+        }
+    }
+}
+
+} // namespace detail
+
+/**
+ * Decode a string of single-octet input codepoints into event records,
+ * instead of calling a processor. Runs are recorded as spans of the input,
+ * so the input must outlive the records.
+ *
+ * Decoding stops early if the arena might fill up. In that case, drain and
+ * clear the arena, then call again with the rest of the input.
+ *
+ * @param str A view of the input string
+ * @param arena The arena for the records
+ * @param state The state, carried from one call to the next
+ * @param config Limits on the sequences (optional)
+ * @return The number of octets decoded
+ */
+template<class Config = decode_config>
+std::size_t decode_events(std::string_view str, event_arena& arena, decode_state& state,
+        const Config& config = {}) noexcept
+{
+    return detail::put_events(str, arena, [&](std::string_view slice, detail::event_writer& writer) {
+        detail::put_string(slice, writer, state, config);
+    });
+}
+
+/**
+ * Decode a string of UTF-8 input code units into event records, instead of
+ * calling a processor. Runs are recorded as spans of the input, so the input
+ * must outlive the records.
+ *
+ * Decoding stops early if the arena might fill up. In that case, drain and
+ * clear the arena, then call again with the rest of the input.
+ *
+ * @param str A view of the input string
+ * @param arena The arena for the records
+ * @param state The state, carried from one call to the next
+ * @param config Limits on the sequences (optional)
+ * @return The number of octets decoded
+ */
+template<class Config = decode_config>
+std::size_t decode_utf8_events(std::string_view str, event_arena& arena, decode_state& state,
+        const Config& config = {}) noexcept
+{
+    return detail::put_events(str, arena, [&](std::string_view slice, detail::event_writer& writer) {
+        detail::put_utf8(slice, writer, state, config);
+    });
+}
+
+/**
+ * Replay the event records in an arena on a processor, in order, as if it had
+ * been the target of the decode. The tracing hooks are not replayed.
+ *
+ * @tparam Processor The processor type
+ * @param arena The arena
+ * @param proc The target processor
+ */
+template<class Processor>
+void replay(const event_arena& arena, Processor&& proc) noexcept(processor_traits<std::decay_t<Processor>>::nothrow)
+{
+    static_assert(is_processor_v<std::decay_t<Processor>>, "parameter 'proc' not a vtdec::processor");
+
+    auto&& p = detail::dispatch(proc);
+
+    p.decode_begin();
+    detail::replay_events(arena, p);
+    p.decode_end(false);
+}
+
+} // namespace vtdec
+
+#endif // #ifndef VTDEC_EVENT_H
@@ -0,0 +1,486 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+#ifndef VTDEC_EXECUTOR_H
+#define VTDEC_EXECUTOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <vtdec/session.h>
+
+namespace vtdec
+{
+
+/**
+ * What one worker of a session executor has done.
+ */
+struct worker_stats
+{
+    /** The number of sessions decoded, one per session per batch. */
+    std::size_t sessions;
+
+    /** The number of pieces of input decoded. */
+    std::size_t pieces;
+
+    /** The number of octets decoded. */
+    std::size_t bytes;
+
+    /** The number of sessions taken from another worker. */
+    std::size_t steals;
+
+    /** The time spent decoding. */
+    std::chrono::steady_clock::duration busy;
+
+    /** The number of other tasks run, e.g. chunks for decode_parallel. */
+    std::size_t tasks;
+};
+
+/**
+ * Spreads the sessions of a session pool across threads. Each batch is cut
+ * into one task per session, holding all of its pieces in order, so a session
+ * is only ever decoded by one thread at a time and its ordering is strict.
+ *
+ * The tasks are sorted from heaviest to lightest and dealt out to the workers
+ * in turn. A worker claims its own tasks, heaviest first, and when it runs out
+ * it steals from the others. Tasks are claimed with an atomic counter per
+ * worker, so a worker never waits on a lock to find work. One heavy session,
+ * say a cat of a huge log, keeps one worker busy while the rest share out the
+ * idle sessions.
+ *
+ * The calling thread is one of the workers, so an executor with one worker
+ * starts no threads. The others are started once and wait between batches.
+ *
+ * Other work cut into independent tasks may be run on the same workers, as
+ * decode_parallel does with the chunks of one big input.
+ */
+class session_executor
+{
+    /**
+     * Internal. The per-worker slot, kept on a cache line of its own.
+     */
+    struct alignas(64) worker
+    {
+        /** The number of tasks in this worker's hand claimed so far. */
+        std::atomic<std::size_t> claimed;
+
+        /** The statistics. Only written by the worker itself. */
+        worker_stats stats;
+    };
+
+    /** The worker slots. */
+    std::unique_ptr<worker[]> m_workers;
+
+    /** The number of workers. */
+    std::size_t m_count;
+
+    /** The threads for all workers but the first. */
+    std::vector<std::thread> m_threads;
+
+    /** Guards the fields below. */
+    std::mutex m_mutex;
+
+    /** Signals a new batch or shutdown to the threads. */
+    std::condition_variable m_start;
+
+    /** Signals the end of a batch to the caller. */
+    std::condition_variable m_done;
+
+    /** The batch number, bumped for each batch. */
+    std::size_t m_generation;
+
+    /** The number of threads still working on the batch. */
+    std::size_t m_running;
+
+    /** True once the threads are to exit. */
+    bool m_stop;
+
+    /** True if the current batch is made of sessions, otherwise false. */
+    bool m_sessions;
+
+    /** The first exception thrown by a processor in the current batch. */
+    std::exception_ptr m_error;
+
+    /** The pieces of the current batch, grouped by session. */
+    std::vector<session_input> m_pieces;
+
+    /**
+     * Internal. All pieces of one session in a batch.
+     */
+    struct task
+    {
+        /** The index of the first piece. */
+        std::size_t begin;
+
+        /** The index past the last piece. */
+        std::size_t end;
+
+        /** The number of octets in the pieces. */
+        std::size_t bytes;
+    };
+
+    /** The tasks of the current batch, heaviest first. */
+    std::vector<task> m_tasks;
+
+    /** The function to run a task of the current batch, returning the number of octets decoded. */
+    std::function<std::size_t(const task&)> m_run;
+
+    /**
+     * Internal. The thread body for a worker other than the first.
+     */
+    void loop(std::size_t w)
+    {
+        std::size_t seen = 0;
+
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock {m_mutex};
+                m_start.wait(lock, [&] { return m_stop || m_generation != seen; });
+
+                if (m_stop)
+                {
+                    return;
+                }
+
+                seen = m_generation;
+            }
+
+            work(w);
+
+            {
+                std::lock_guard<std::mutex> lock {m_mutex};
+
+                if (--m_running == 0)
+                {
+                    m_done.notify_one();
+                }
+            }
+        }
+    }
+
+    /**
+     * Internal. Claim the next task from a worker's hand.
+     *
+     * @param from The worker whose hand to claim from
+     * @return The index of the task, or the number of tasks if none are left
+     */
+    std::size_t claim(std::size_t from)
+    {
+        // Tasks are dealt in turn, so the hand of worker w holds tasks w, w + n, w + 2n, ...
+        auto k = m_workers[from].claimed.load(std::memory_order_relaxed);
+
+        // Peek first, so an empty hand is not bumped over and over
+        if (from + k * m_count >= m_tasks.size())
+        {
+            return m_tasks.size();
+        }
+
+        k = m_workers[from].claimed.fetch_add(1, std::memory_order_relaxed);
+        return std::min(from + k * m_count, m_tasks.size());
+    }
+
+    /**
+     * Internal. Run tasks of the current batch until none are left anywhere.
+     *
+     * @param w The index of the worker
+     */
+    void work(std::size_t w)
+    {
+        auto& stats = m_workers[w].stats;
+        auto start = std::chrono::steady_clock::now();
+
+        for (std::size_t victim = 0; victim < m_count; ++victim)
+        {
+            auto from = (w + victim) % m_count;
+
+            for (std::size_t i; (i = claim(from)) < m_tasks.size();)
+            {
+                auto& t = m_tasks[i];
+
+                // The octets of a session are known up front, and those of another task once it is done
+                if (m_sessions)
+                {
+                    stats.sessions += 1;
+                    stats.pieces += t.end - t.begin;
+                    stats.bytes += t.bytes;
+                }
+                else
+                {
+                    stats.tasks += 1;
+                }
+
+                stats.steals += from != w;
+
+                try
+                {
+                    stats.bytes += m_run(t);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock {m_mutex};
+
+                    if (!m_error)
+                    {
+                        m_error = std::current_exception();
+                    }
+                }
+            }
+        }
+
+        stats.busy += std::chrono::steady_clock::now() - start;
+    }
+
+    /**
+     * Internal. Start the tasks of a batch on the threads.
+     */
+    void start()
+    {
+        for (std::size_t w = 0; w < m_count; ++w)
+        {
+            m_workers[w].claimed.store(0, std::memory_order_relaxed);
+        }
+
+        m_error = nullptr;
+
+        // The lock orders everything above before the threads see the new batch
+        {
+            std::lock_guard<std::mutex> lock {m_mutex};
+            m_running = m_count - 1;
+            ++m_generation;
+        }
+
+        m_start.notify_all();
+    }
+
+    /**
+     * Internal. Join in on the tasks of a batch and wait for them all.
+     */
+    void finish()
+    {
+        work(0);
+
+        {
+            std::unique_lock<std::mutex> lock {m_mutex};
+            m_done.wait(lock, [&] { return m_running == 0; });
+        }
+
+        m_run = nullptr;
+
+        if (m_error)
+        {
+            std::rethrow_exception(std::exchange(m_error, nullptr));
+        }
+    }
+
+public:
+    /**
+     * Create an executor and start its threads.
+     *
+     * @param p_count The number of workers, counting the calling thread (optional)
+     */
+    explicit session_executor(std::size_t p_count = std::max(1u, std::thread::hardware_concurrency()))
+            : m_workers {new worker[std::max<std::size_t>(p_count, 1)]}
+            , m_count {std::max<std::size_t>(p_count, 1)}
+            , m_generation {0}
+            , m_running {0}
+            , m_stop {false}
+            , m_sessions {false}
+    {
+        reset_stats();
+
+        for (std::size_t w = 1; w < m_count; ++w)
+        {
+            m_threads.emplace_back([this, w] { loop(w); });
+        }
+    }
+
+    session_executor(const session_executor&) = delete;
+
+    session_executor& operator=(const session_executor&) = delete;
+
+    /**
+     * Stop and join the threads.
+     */
+    ~session_executor()
+    {
+        {
+            std::lock_guard<std::mutex> lock {m_mutex};
+            m_stop = true;
+        }
+
+        m_start.notify_all();
+
+        for (auto&& t : m_threads)
+        {
+            t.join();
+        }
+    }
+
+    /**
+     * @return The number of workers, counting the calling thread
+     */
+    std::size_t size() const
+    { return m_count; }
+
+    /**
+     * @param w The index of a worker
+     * @return What the worker has done since the stats were last reset
+     */
+    const worker_stats& stats(std::size_t w) const
+    { return m_workers[w].stats; }
+
+    /**
+     * Reset the stats of all workers.
+     */
+    void reset_stats()
+    {
+        for (std::size_t w = 0; w < m_count; ++w)
+        {
+            m_workers[w].stats = {};
+        }
+    }
+
+    /**
+     * Feed a batch of input to the sessions of a pool, spread across the
+     * workers, and wait for all of it to be decoded. Pieces for the same
+     * session are decoded in the order given. Different sessions are decoded
+     * in no particular order, and at the same time.
+     *
+     * If a processor throws, the rest of its session's pieces in the batch
+     * are dropped, but other sessions carry on. Once the batch is done, the
+     * first exception is thrown again.
+     *
+     * @tparam Processor The processor type
+     * @tparam Config The config type
+     * @tparam InputIter The input iterator type, over session_input
+     * @param pool The session pool
+     * @param begin An iterator to the beginning of the batch
+     * @param end An iterator to the end of the batch
+     */
+    template<class Processor, class Config, class InputIter>
+    void feed(session_pool<Processor, Config>& pool, InputIter begin, InputIter end)
+    {
+        // Group the pieces by session, keeping their order within each
+        m_pieces.assign(begin, end);
+        std::stable_sort(m_pieces.begin(), m_pieces.end(), [](auto&& a, auto&& b) { return a.session < b.session; });
+
+        m_tasks.clear();
+
+        for (std::size_t i = 0; i < m_pieces.size();)
+        {
+            task t {i, i, 0};
+
+            for (; t.end < m_pieces.size() && m_pieces[t.end].session == m_pieces[i].session; ++t.end)
+            {
+                t.bytes += m_pieces[t.end].data.size();
+            }
+
+            m_tasks.push_back(t);
+            i = t.end;
+        }
+
+        // Heaviest first, so the big sessions start early and the small ones fill in around them
+        std::stable_sort(m_tasks.begin(), m_tasks.end(), [](auto&& a, auto&& b) { return a.bytes > b.bytes; });
+
+        m_sessions = true;
+        m_run = [&pool, this](const task& t) {
+            for (auto i = t.begin; i < t.end; ++i)
+            {
+                pool.feed(m_pieces[i].session, m_pieces[i].data);
+            }
+
+            return std::size_t {0};
+        };
+
+        start();
+        finish();
+    }
+
+    /**
+     * Start a function on each of a number of tasks, spread across the
+     * workers, and return at once. The tasks are dealt out in order, so put
+     * the heaviest first. The calling thread is free to do other work, and
+     * joins in once it calls wait. Nothing else may be run until then.
+     *
+     * @tparam Function The function type
+     * @param count The number of tasks
+     * @param f The function, called with the index of a task, returning the number of octets it decoded
+     */
+    template<class Function>
+    void post(std::size_t count, Function f)
+    {
+        m_tasks.clear();
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            m_tasks.push_back({i, i + 1, 0});
+        }
+
+        m_sessions = false;
+        m_run = [f = std::move(f)](const task& t) -> std::size_t { return f(t.begin); };
+
+        start();
+    }
+
+    /**
+     * Join in on the tasks started by post and wait for them all. If any
+     * threw, the others carried on, and the first exception is thrown again
+     * now.
+     */
+    void wait()
+    { finish(); }
+
+    /**
+     * Run a function on each of a number of tasks, spread across the
+     * workers, and wait for them all, as with post and then wait.
+     *
+     * @tparam Function The function type
+     * @param count The number of tasks
+     * @param f The function, called with the index of a task, returning the number of octets it decoded
+     */
+    template<class Function>
+    void run(std::size_t count, Function f)
+    {
+        post(count, std::move(f));
+        wait();
+    }
+};
+
+} // namespace vtdec
+
+#endif // #ifndef VTDEC_EXECUTOR_H
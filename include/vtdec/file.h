@@ -0,0 +1,256 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+#ifndef VTDEC_FILE_H
+#define VTDEC_FILE_H
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <vtdec/decoder.h>
+
+namespace vtdec
+{
+
+/**
+ * The outcome of decoding a file.
+ */
+struct decode_file_result
+{
+    /** The error, if any. */
+    std::error_code error;
+
+    /** The number of bytes decoded. */
+    std::uint64_t bytes;
+
+    /** The time taken, in seconds. */
+    double seconds;
+
+    /**
+     * @return The throughput in bytes per second
+     */
+    double throughput() const
+    { return seconds > 0 ? bytes / seconds : 0; }
+};
+
+/**
+ * Implementation details.
+ */
+namespace detail
+{
+
+/**
+ * Internal. An open file descriptor, closed on destruction.
+ */
+struct file_handle
+{
+    int fd;
+
+    ~file_handle()
+    {
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+    }
+};
+
+/**
+ * Internal. A mapping, unmapped on destruction. A window mapped into a
+ * reservation has no size of its own, as the reservation unmaps it.
+ */
+struct file_window
+{
+    void* addr;
+    std::size_t size;
+
+    ~file_window()
+    {
+        if (addr != MAP_FAILED && size > 0)
+        {
+            ::munmap(addr, size);
+        }
+    }
+};
+
+/**
+ * Internal. The error code for the current errno.
+ */
+inline std::error_code last_error()
+{ return {errno, std::generic_category()}; }
+
+} // namespace detail
+
+/**
+ * Decode a file of UTF-8 input, e.g. a typescript or a raw capture. The file
+ * is mapped into memory a window at a time and decoded in place, without
+ * copying. The kernel is told the file is read in order, so it reads ahead
+ * and drops pages behind.
+ *
+ * Windows of 2 MiB or more are rounded to a multiple of 2 MiB and, on Linux,
+ * mapped at a 2 MiB boundary and advised to use huge pages. Whether they get
+ * huge pages is up to the kernel. Read-only file mappings need a kernel built
+ * with CONFIG_READ_ONLY_THP_FOR_FS, and even then khugepaged collapses them
+ * some time later, so a single pass over a file often sees none.
+ *
+ * The file must not shrink while it is being decoded. Reading a mapped page
+ * past the new end of the file raises SIGBUS, which ends the process unless
+ * it is handled.
+ *
+ * The processor sees one decode operation over the whole file, as if it had
+ * been decoded in one piece, and the end of the file is flushed. If the file
+ * cannot be opened, or is not a regular file, the processor is not called.
+ * If it cannot be mapped partway through, the processor is told the decode
+ * operation ended where it stopped. Either way, the error is returned.
+ *
+ * @tparam Processor The processor type
+ * @param path The path of the file
+ * @param proc The target processor
+ * @param config Limits on the sequences (optional)
+ * @param window The size of a window in bytes, rounded up to a whole number of pages (optional)
+ * @return The outcome
+ */
+template<class Processor, class Config = decode_config>
+decode_file_result decode_file(const char* path, Processor&& proc, const Config& config = {},
+        std::size_t window = std::size_t {1} << 26)
+{
+    static_assert(is_processor_v<std::decay_t<Processor>>, "parameter 'proc' not a vtdec::processor");
+
+    auto start = std::chrono::steady_clock::now();
+    decode_file_result result {{}, 0, 0};
+
+    auto finish = [&] {
+        result.seconds = std::chrono::duration<double> {std::chrono::steady_clock::now() - start}.count();
+        return result;
+    };
+
+    detail::file_handle file {::open(path, O_RDONLY | O_CLOEXEC)};
+
+    if (file.fd < 0)
+    {
+        result.error = detail::last_error();
+        return finish();
+    }
+
+    struct stat st;
+
+    if (::fstat(file.fd, &st) != 0)
+    {
+        result.error = detail::last_error();
+        return finish();
+    }
+
+    // Only a regular file can be mapped
+    if (!S_ISREG(st.st_mode))
+    {
+        result.error = std::make_error_code(std::errc::invalid_argument);
+        return finish();
+    }
+
+    // Offsets must be page-aligned, and huge pages are 2 MiB on common hardware
+    auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    auto align = window >= (std::size_t {1} << 21) ? std::size_t {1} << 21 : page;
+    window = (window + align - 1) / align * align;
+
+#if defined(POSIX_FADV_SEQUENTIAL)
+    ::posix_fadvise(file.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    // Reserve address space for a window at a 2 MiB boundary, where huge pages can go
+    // Each window is then mapped over the reservation in place of the last one
+#if defined(MADV_HUGEPAGE)
+    auto huge = align > page;
+#else
+    auto huge = false;
+#endif
+
+    detail::file_window reserve {huge ? ::mmap(nullptr, window + align, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)
+                                      : MAP_FAILED, window + align};
+    char* base = nullptr;
+
+    if (reserve.addr != MAP_FAILED)
+    {
+        auto addr = reinterpret_cast<std::uintptr_t>(reserve.addr);
+        base = reinterpret_cast<char*>((addr + align - 1) / align * align);
+    }
+
+    decoder<std::remove_reference_t<Processor>, Config> dec {proc, config};
+    auto size = static_cast<std::uint64_t>(st.st_size);
+
+    // Begin the decode operation even if the file is empty, as decode does
+    dec.feed(std::string_view {});
+
+    while (result.bytes < size)
+    {
+        auto length = static_cast<std::size_t>(size - result.bytes < window ? size - result.bytes : window);
+
+        auto offset = static_cast<off_t>(result.bytes);
+        detail::file_window map {base ? ::mmap(base, length, PROT_READ, MAP_PRIVATE | MAP_FIXED, file.fd, offset)
+                                      : ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file.fd, offset),
+                base ? 0 : length};
+
+        if (map.addr == MAP_FAILED)
+        {
+            result.error = detail::last_error();
+            dec.finish();
+            return finish();
+        }
+
+        ::madvise(map.addr, length, MADV_SEQUENTIAL);
+
+#if defined(MADV_HUGEPAGE)
+        if (base)
+        {
+            ::madvise(map.addr, length, MADV_HUGEPAGE);
+        }
+#endif
+
+        dec.feed(std::string_view {static_cast<const char*>(map.addr), length});
+        result.bytes += length;
+    }
+
+    dec.flush();
+    return finish();
+}
+
+} // namespace vtdec
+
+#endif // #if defined(__unix__) || defined(__APPLE__)
+
+#endif // #ifndef VTDEC_FILE_H
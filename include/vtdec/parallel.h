@@ -0,0 +1,334 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+#ifndef VTDEC_PARALLEL_H
+#define VTDEC_PARALLEL_H
+
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <vtdec/decode.h>
+#include <vtdec/event.h>
+#include <vtdec/executor.h>
+
+namespace vtdec
+{
+
+/**
+ * Implementation details.
+ */
+namespace detail
+{
+
+/**
+ * Internal. Determine if a state is clean, i.e. in the ground state with no
+ * sequence or UTF-8 codepoint pending. The rest of a clean state is dead, so
+ * decoding from any clean state gives the same callbacks as from a new one.
+ */
+inline bool is_clean(const decode_state& s)
+{ return s.state == vtdec::state::ground && s.sequence == sequence::idk && s.utf8_remaining == 0; }
+
+/**
+ * Internal. Find a good place to cut the input at or after a position. Just
+ * before an ESC, the decoder is almost always clean, as whatever came before
+ * has most likely ended. Failing that, a UTF-8 codepoint is not cut in two.
+ */
+template<bool Utf8>
+std::size_t find_cut(std::string_view str, std::size_t pos)
+{
+    if (pos >= str.size())
+    {
+        return str.size();
+    }
+
+    auto esc = str.substr(pos, 4096).find('\x1b');
+
+    if (esc != std::string_view::npos)
+    {
+        return pos + esc;
+    }
+
+    if constexpr (Utf8)
+    {
+        for (int i = 0; i < 3 && pos < str.size() && (static_cast<unsigned char>(str[pos]) & 0xc0) == 0x80; ++i)
+        {
+            ++pos;
+        }
+    }
+
+    return pos;
+}
+
+/**
+ * Internal. Put a string serially, as octets or as UTF-8.
+ */
+template<bool Utf8, class Processor, class Config>
+void put_serial(std::string_view str, Processor&& p, decode_state& s, const Config& cfg)
+{
+    if constexpr (Utf8)
+    {
+        put_utf8(str, p, s, cfg);
+    }
+    else
+    {
+        put_string(str, p, s, cfg);
+    }
+}
+
+/**
+ * Internal. One chunk of a round of speculative decoding.
+ */
+struct speculation
+{
+    /** The offset of the chunk in the input. */
+    std::size_t begin;
+
+    /** The offset past the end of the chunk. */
+    std::size_t end;
+
+    /** The number of octets decoded into the arena. */
+    std::size_t done;
+
+    /** True if the chunk was decoded from the true state, not a guess. */
+    bool exact;
+
+    /** The state, from the start of the chunk to the end of what was decoded. */
+    decode_state state;
+
+    /** The records. */
+    event_arena arena;
+};
+
+/**
+ * Internal. Decode a string across the workers of an executor.
+ *
+ * The input is cut into rounds of one chunk per worker. In each round, the
+ * workers decode every chunk into event records at once, each from a clean
+ * state, on the bet that the decoder is clean at each cut. Only the very
+ * first chunk is decoded from the true state. Then, one chunk at a time, the
+ * records are replayed on the processor if the bet was right. If it was
+ * wrong, the chunk is decoded again, serially, from the true state. A chunk
+ * with too many records for its arena is finished serially, too.
+ *
+ * Replay runs on the calling thread, while the workers go on to the next
+ * round, so there are two sets of chunks and arenas, used in turn. With
+ * enough workers, the replay is then the limit, which is cheaper than the
+ * decode by the cost of the table walk.
+ */
+template<bool Utf8, class Processor, class Config>
+decode_state put_parallel(std::string_view str, Processor& proc, session_executor& exec, decode_state state,
+        const Config& cfg, std::size_t chunk)
+{
+    auto&& p = dispatch(proc);
+
+    p.decode_begin();
+
+    // Records carry no tracing, so a processor that wants it is decoded serially
+    if (processor_traits<std::decay_t<Processor>>::wants_trace || exec.size() == 1 || str.size() <= chunk)
+    {
+        put_serial<Utf8>(str, p, state, cfg);
+        p.decode_end(false);
+        return state;
+    }
+
+    // Typical terminal output makes well under one record per two octets
+    auto event_capacity = chunk / 2 + 64;
+    auto sequence_capacity = chunk / 16 + 8;
+
+    auto count = exec.size();
+
+    std::vector<event> events(2 * count * event_capacity);
+    std::vector<csi_sequence> sequences(2 * count * sequence_capacity);
+    std::vector<speculation> parts(2 * count);
+
+    for (std::size_t i = 0; i < 2 * count; ++i)
+    {
+        parts[i].arena = {events.data() + i * event_capacity, event_capacity, 0,
+                sequences.data() + i * sequence_capacity, sequence_capacity, 0};
+    }
+
+    std::size_t pos = 0;
+
+    // Cut the next round into a set of chunks, returning the number of chunks
+    auto cut = [&](speculation* round) {
+        std::size_t n = 0;
+
+        for (; n < count && pos < str.size(); ++n)
+        {
+            auto& part = round[n];
+
+            part.begin = pos;
+            part.end = find_cut<Utf8>(str, pos + chunk);
+            part.done = 0;
+            part.exact = pos == 0;
+            part.state = pos == 0 ? state : decode_state {};
+            part.arena.clear();
+
+            pos = part.end;
+        }
+
+        return n;
+    };
+
+    // The task to decode one of a set of chunks into its arena
+    auto speculate = [str, &cfg](speculation* round) {
+        return [round, str, &cfg](std::size_t i) {
+            auto& part = round[i];
+            auto slice = str.substr(part.begin, part.end - part.begin);
+
+            part.done = put_events(slice, part.arena, [&](std::string_view s, event_writer& writer) {
+                put_serial<Utf8>(s, writer, part.state, cfg);
+            });
+
+            return part.done;
+        };
+    };
+
+    auto current = parts.data();
+    auto next = parts.data() + count;
+
+    auto n = cut(current);
+    exec.run(n, speculate(current));
+
+    while (n != 0)
+    {
+        // Start on the next round before replaying this one
+        auto next_n = cut(next);
+
+        if (next_n != 0)
+        {
+            exec.post(next_n, speculate(next));
+        }
+
+        try
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                auto& part = current[i];
+
+                if (part.exact || is_clean(state))
+                {
+                    replay_events(part.arena, p);
+                    state = part.state;
+
+                    put_serial<Utf8>(str.substr(part.begin + part.done, part.end - part.begin - part.done), p, state,
+                            cfg);
+                }
+                else
+                {
+                    put_serial<Utf8>(str.substr(part.begin, part.end - part.begin), p, state, cfg);
+                }
+            }
+        }
+        catch (...)
+        {
+            // The workers must be done with the chunks before they go away
+            if (next_n != 0)
+            {
+                exec.wait();
+            }
+
+            throw;
+        }
+
+        if (next_n != 0)
+        {
+            exec.wait();
+        }
+
+        std::swap(current, next);
+        n = next_n;
+    }
+
+    p.decode_end(false);
+    return state;
+}
+
+} // namespace detail
+
+/**
+ * Decode a string of single-octet input codepoints on many threads at once,
+ * for offline work like replaying a recorded session. The processor sees the
+ * same callbacks as from decode, in the same order, all on the calling
+ * thread. The input must be in memory in full.
+ *
+ * The input is cut into chunks, which are decoded at once on the workers of
+ * an executor, each on the bet that the decoder is in the ground state where
+ * the chunk begins. The chunks are cut just before an ESC where there is one
+ * close by, so the bet is almost always right. Where it is wrong, the chunk is
+ * decoded again. A processor that wants tracing is decoded serially.
+ *
+ * The records are replayed on the calling thread while the workers decode
+ * the next chunks. With enough workers, throughput is bounded by that replay,
+ * which skips the table walk but still costs one processor call per record.
+ *
+ * @tparam Processor The processor type
+ * @param str A view of the input string
+ * @param proc The target processor
+ * @param exec The executor
+ * @param state The initial state (optional)
+ * @param config Limits on the sequences (optional)
+ * @param chunk The size of a chunk in octets (optional)
+ * @return The final state
+ */
+template<class Processor, class Config = decode_config>
+decode_state decode_parallel(std::string_view str, Processor&& proc, session_executor& exec,
+        decode_state state = {}, const Config& config = {}, std::size_t chunk = 1 << 18)
+{
+    static_assert(is_processor_v<std::decay_t<Processor>>, "parameter 'proc' not a vtdec::processor");
+
+    return detail::put_parallel<false>(str, proc, exec, state, config, chunk);
+}
+
+/**
+ * Decode a string of UTF-8 input code units on many threads at once, as for
+ * decode_parallel. Chunks are not cut inside a codepoint.
+ *
+ * @tparam Processor The processor type
+ * @param str A view of the input string
+ * @param proc The target processor
+ * @param exec The executor
+ * @param state The initial state (optional)
+ * @param config Limits on the sequences (optional)
+ * @param chunk The size of a chunk in octets (optional)
+ * @return The final state
+ */
+template<class Processor, class Config = decode_config>
+decode_state decode_utf8_parallel(std::string_view str, Processor&& proc, session_executor& exec,
+        decode_state state = {}, const Config& config = {}, std::size_t chunk = 1 << 18)
+{
+    static_assert(is_processor_v<std::decay_t<Processor>>, "parameter 'proc' not a vtdec::processor");
+
+    return detail::put_parallel<true>(str, proc, exec, state, config, chunk);
+}
+
+} // namespace vtdec
+
+#endif // #ifndef VTDEC_PARALLEL_H
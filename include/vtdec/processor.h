@@ -28,6 +28,12 @@
 #ifndef VTDEC_PROCESSOR_H
 #define VTDEC_PROCESSOR_H
 
+#include <string_view>
+#include <type_traits>
+
+#include <vtdec/sequence.h>
+#include <vtdec/table.h>
+
 namespace vtdec
 {
 
@@ -47,6 +53,34 @@ struct processor
     {
     }
 
+    /**
+     * A run of printable single-octet codepoints passthrough. By default, each
+     * codepoint is passed to print in turn.
+     *
+     * @param str A view of the codepoints, valid only for the call
+     */
+    virtual void print_run(std::string_view str)
+    {
+        for (auto c : str)
+        {
+            print(static_cast<unsigned char>(c));
+        }
+    }
+
+    /**
+     * A run of printable 32-bit codepoints passthrough. By default, each
+     * codepoint is passed to print in turn.
+     *
+     * @param str A view of the codepoints, valid only for the call
+     */
+    virtual void print_run(std::u32string_view str)
+    {
+        for (auto c : str)
+        {
+            print(c);
+        }
+    }
+
     /**
      * A single-codepoint control has been issued.
      *
@@ -72,6 +106,17 @@ struct processor
     {
     }
 
+    /**
+     * A control sequence (CSI) has been dispatched. This comes just before the
+     * sequence ends.
+     *
+     * @param seq The parsed parameters, intermediates, and private marker
+     * @param final The final character
+     */
+    virtual void csi_dispatch(const csi_sequence& seq, char final)
+    {
+    }
+
     /**
      * A control sequence has ended.
      *
@@ -88,6 +133,17 @@ struct processor
     {
     }
 
+    /**
+     * A device control string (DCS) has been hooked. This comes once, just
+     * before the final character arrives through dcs_put.
+     *
+     * @param seq The parsed parameters, intermediates, and private marker
+     * @param final The final character
+     */
+    virtual void dcs_hook(const csi_sequence& seq, char final)
+    {
+    }
+
     /**
      * A codepoint has arrived as part of a device control string (DCS).
      *
@@ -97,6 +153,25 @@ struct processor
     {
     }
 
+    /**
+     * A run of single-octet codepoints has arrived as the data of a device
+     * control string (DCS). By default, each codepoint is passed to dcs_put in
+     * turn.
+     *
+     * The view points straight into the input, so no copy is made. Runs may
+     * include C0 controls other than CAN, SUB, and ESC. Data may arrive over
+     * several runs and calls to dcs_put, in order.
+     *
+     * @param str A view of the codepoints, valid only for the call
+     */
+    virtual void dcs_data(std::string_view str)
+    {
+        for (auto c : str)
+        {
+            dcs_put(static_cast<unsigned char>(c));
+        }
+    }
+
     /**
      * A device control string (DCS) has ended.
      *
@@ -122,6 +197,24 @@ struct processor
     {
     }
 
+    /**
+     * A run of single-octet codepoints has arrived as part of an operating
+     * system command (OSC). By default, each codepoint is passed to osc_put in
+     * turn.
+     *
+     * The view points straight into the input, so no copy is made. A payload
+     * may arrive over several runs and calls to osc_put, in order.
+     *
+     * @param str A view of the codepoints, valid only for the call
+     */
+    virtual void osc_data(std::string_view str)
+    {
+        for (auto c : str)
+        {
+            osc_put(static_cast<unsigned char>(c));
+        }
+    }
+
     /**
      * An operating system command (OSC) string has ended
      *
@@ -176,6 +269,523 @@ struct processor
     }
 };
 
+/**
+ * A statically-dispatched decoded event processor. Derive from this, passing
+ * the derived type, and hide whichever hooks are of interest to receive decode
+ * feedback without virtual calls. Hooks left alone compile away completely.
+ *
+ * @tparam Derived The derived processor type
+ */
+template<class Derived>
+struct static_processor
+{
+    /**
+     * Printable codepoint passthrough.
+     *
+     * @param c The codepoint value
+     */
+    void print(char32_t c) noexcept
+    {
+    }
+
+    /**
+     * A run of printable single-octet codepoints passthrough. By default, each
+     * codepoint is passed to print in turn.
+     *
+     * Hiding only one overload of print_run hides the other, too. The decoder
+     * falls back to print for any overload it cannot see.
+     *
+     * @param str A view of the codepoints, valid only for the call
+     */
+    void print_run(std::string_view str) noexcept(noexcept(std::declval<Derived&>().print(char32_t {})))
+    {
+        for (auto c : str)
+        {
+            derived().print(static_cast<unsigned char>(c));
+        }
+    }
+
+    /**
+     * A run of printable 32-bit codepoints passthrough. By default, each
+     * codepoint is passed to print in turn.
+     *
+     * @param str A view of the codepoints, valid only for the call
+     */
+    void print_run(std::u32string_view str) noexcept(noexcept(std::declval<Derived&>().print(char32_t {})))
+    {
+        for (auto c : str)
+        {
+            derived().print(c);
+        }
+    }
+
+    /**
+     * A single-codepoint control has been issued.
+     *
+     * @param c The codepoint value
+     */
+    void ctl(char c) noexcept
+    {
+    }
+
+    /**
+     * A control sequence has begun.
+     */
+    void ctl_begin() noexcept
+    {
+    }
+
+    /**
+     * A codepoint has arrived as part of a control sequence.
+     *
+     * @param c The codepoint value
+     */
+    void ctl_put(char32_t c) noexcept
+    {
+    }
+
+    /**
+     * A control sequence (CSI) has been dispatched. This comes just before the
+     * sequence ends.
+     *
+     * @param seq The parsed parameters, intermediates, and private marker
+     * @param final The final character
+     */
+    void csi_dispatch(const csi_sequence& seq, char final) noexcept
+    {
+    }
+
+    /**
+     * A control sequence has ended.
+     *
+     * @param cancel True on cancellation, otherwise false
+     */
+    void ctl_end(bool cancel) noexcept
+    {
+    }
+
+    /**
+     * A device control string (DCS) has begun.
+     */
+    void dcs_begin() noexcept
+    {
+    }
+
+    /**
+     * A device control string (DCS) has been hooked. This comes once, just
+     * before the final character arrives through dcs_put.
+     *
+     * @param seq The parsed parameters, intermediates, and private marker
+     * @param final The final character
+     */
+    void dcs_hook(const csi_sequence& seq, char final) noexcept
+    {
+    }
+
+    /**
+     * A codepoint has arrived as part of a device control string (DCS).
+     *
+     * @param c The codepoint value
+     */
+    void dcs_put(char32_t c) noexcept
+    {
+    }
+
+    /**
+     * A run of single-octet codepoints has arrived as the data of a device
+     * control string (DCS). By default, each codepoint is passed to dcs_put in
+     * turn.
+     *
+     * The view points straight into the input, so no copy is made. Runs may
+     * include C0 controls other than CAN, SUB, and ESC. Data may arrive over
+     * several runs and calls to dcs_put, in order.
+     *
+     * @param str A view of the codepoints, valid only for the call
+     */
+    void dcs_data(std::string_view str) noexcept(noexcept(std::declval<Derived&>().dcs_put(char32_t {})))
+    {
+        for (auto c : str)
+        {
+            derived().dcs_put(static_cast<unsigned char>(c));
+        }
+    }
+
+    /**
+     * A device control string (DCS) has ended.
+     *
+     * @param cancel True on cancellation, otherwise false
+     */
+    void dcs_end(bool cancel) noexcept
+    {
+    }
+
+    /**
+     * An operating system command (OSC) string has begun.
+     */
+    void osc_begin() noexcept
+    {
+    }
+
+    /**
+     * A codepoint has arrived as part of an operating system command (OSC).
+     *
+     * @param c The codepoint value
+     */
+    void osc_put(char32_t c) noexcept
+    {
+    }
+
+    /**
+     * A run of single-octet codepoints has arrived as part of an operating
+     * system command (OSC). By default, each codepoint is passed to osc_put in
+     * turn.
+     *
+     * The view points straight into the input, so no copy is made. A payload
+     * may arrive over several runs and calls to osc_put, in order.
+     *
+     * @param str A view of the codepoints, valid only for the call
+     */
+    void osc_data(std::string_view str) noexcept(noexcept(std::declval<Derived&>().osc_put(char32_t {})))
+    {
+        for (auto c : str)
+        {
+            derived().osc_put(static_cast<unsigned char>(c));
+        }
+    }
+
+    /**
+     * An operating system command (OSC) string has ended
+     *
+     * @param cancel True on cancellation, otherwise false
+     */
+    void osc_end(bool cancel) noexcept
+    {
+    }
+
+    /**
+     * A decode operation has begun.
+     */
+    void decode_begin() noexcept
+    {
+    }
+
+    /**
+     * A codepoint has arrived as part of a decode operation.
+     *
+     * @param c The codepoint value
+     */
+    void decode_put(char32_t c) noexcept
+    {
+    }
+
+    /**
+     * An action is about to be performed as part of a decode operation.
+     *
+     * @param act The impending action
+     */
+    void decode_action(int act) noexcept
+    {
+    }
+
+    /**
+     * A transition is about to be made as part of a decode operation.
+     *
+     * @param src The source state
+     * @param dst The destination state
+     */
+    void decode_transition(int src, int dst) noexcept
+    {
+    }
+
+    /**
+     * A decode operation has ended.
+     *
+     * @param cancel True on cancellation, otherwise false
+     */
+    void decode_end(bool cancel) noexcept
+    {
+    }
+
+protected:
+    /**
+     * @return This processor as its derived type
+     */
+    Derived& derived()
+    { return static_cast<Derived&>(*this); }
+};
+
+/**
+ * Whether a type is a statically-dispatched processor.
+ *
+ * @tparam Processor The processor type
+ */
+template<class Processor>
+inline constexpr bool is_static_processor_v = std::is_base_of_v<static_processor<Processor>, Processor>;
+
+/**
+ * Whether a type is a processor of either kind.
+ *
+ * @tparam Processor The processor type
+ */
+template<class Processor>
+inline constexpr bool is_processor_v = std::is_base_of_v<processor, Processor>
+        || is_static_processor_v<Processor>;
+
+namespace detail
+{
+
+/**
+ * Internal. Whether a static processor hides any of the tracing hooks.
+ */
+template<class Processor>
+constexpr bool hides_trace_hooks()
+{
+    using base = static_processor<Processor>;
+
+    return !std::is_same_v<decltype(&Processor::decode_put), void (base::*)(char32_t) noexcept>
+            || !std::is_same_v<decltype(&Processor::decode_action), void (base::*)(int) noexcept>
+            || !std::is_same_v<decltype(&Processor::decode_transition), void (base::*)(int, int) noexcept>;
+}
+
+/**
+ * Internal. Default for processor_traits::wants_trace.
+ */
+template<class Processor, class = void>
+struct default_wants_trace
+{
+    // Virtual hooks may be overridden anywhere, so assume the worst
+    static constexpr bool value = !is_static_processor_v<Processor> || hides_trace_hooks<Processor>();
+};
+
+/**
+ * Internal. Default for processor_traits::wants_trace. The processor says.
+ */
+template<class Processor>
+struct default_wants_trace<Processor, std::void_t<decltype(Processor::wants_trace)>>
+{
+    static constexpr bool value = Processor::wants_trace;
+};
+
+/**
+ * Internal. Default for processor_traits::table_backend.
+ */
+template<class Processor, class = void>
+struct default_table_backend
+{
+    using type = table_backend_fused;
+};
+
+/**
+ * Internal. Default for processor_traits::table_backend. The processor says.
+ */
+template<class Processor>
+struct default_table_backend<Processor, std::void_t<typename Processor::table_backend>>
+{
+    using type = typename Processor::table_backend;
+};
+
+/**
+ * Internal. Whether a run hook of a processor cannot throw. A processor that
+ * hides the hook behind one of another kind counts, as the decoder falls back
+ * to the per-codepoint hook.
+ */
+template<class Processor, class Hook, class View, class = void>
+inline constexpr bool run_hook_nothrow_v = true;
+
+/**
+ * Internal. Whether a run hook of a processor cannot throw.
+ */
+template<class Processor, class Hook, class View>
+inline constexpr bool run_hook_nothrow_v<Processor, Hook, View,
+        std::void_t<decltype(Hook {}(std::declval<Processor&>(), std::declval<View>()))>> =
+        noexcept(Hook {}(std::declval<Processor&>(), std::declval<View>()));
+
+/**
+ * Internal. Call the print_run hook of a processor.
+ */
+struct print_run_hook
+{
+    template<class Processor, class View>
+    auto operator()(Processor& p, View str) const noexcept(noexcept(p.print_run(str))) -> decltype(p.print_run(str))
+    { return p.print_run(str); }
+};
+
+/**
+ * Internal. Default for processor_traits::nothrow.
+ */
+template<class Processor>
+constexpr bool default_nothrow(Processor* p = nullptr)
+{
+    // The processor is only named in unevaluated operands
+    if constexpr (is_static_processor_v<Processor>)
+    {
+        return noexcept(p->print(char32_t {}))
+                && run_hook_nothrow_v<Processor, print_run_hook, std::string_view>
+                && run_hook_nothrow_v<Processor, print_run_hook, std::u32string_view>
+                && noexcept(p->ctl(char {}))
+                && noexcept(p->ctl_begin())
+                && noexcept(p->ctl_put(char32_t {}))
+                && noexcept(p->csi_dispatch(std::declval<const csi_sequence&>(), char {}))
+                && noexcept(p->ctl_end(bool {}))
+                && noexcept(p->dcs_begin())
+                && noexcept(p->dcs_hook(std::declval<const csi_sequence&>(), char {}))
+                && noexcept(p->dcs_put(char32_t {}))
+                && noexcept(p->dcs_data(std::string_view {}))
+                && noexcept(p->dcs_end(bool {}))
+                && noexcept(p->osc_begin())
+                && noexcept(p->osc_put(char32_t {}))
+                && noexcept(p->osc_data(std::string_view {}))
+                && noexcept(p->osc_end(bool {}))
+                && noexcept(p->decode_begin())
+                && noexcept(p->decode_put(char32_t {}))
+                && noexcept(p->decode_action(int {}))
+                && noexcept(p->decode_transition(int {}, int {}))
+                && noexcept(p->decode_end(bool {}));
+    }
+    else
+    {
+        // Virtual hooks may be overridden to throw
+        return false;
+    }
+}
+
+} // namespace detail
+
+/**
+ * Compile-time info about a processor. Specialize this or declare the members
+ * on the processor itself to customize decoding.
+ *
+ * @tparam Processor The processor type
+ */
+template<class Processor>
+struct processor_traits
+{
+    /**
+     * Whether the processor wants the decode_put, decode_action, and
+     * decode_transition tracing hooks. If not, they are never called.
+     *
+     * By default, a static processor wants tracing only if it hides one of the
+     * tracing hooks. A virtual processor always wants tracing unless it
+     * declares a static constexpr bool wants_trace member to the contrary.
+     */
+    static constexpr bool wants_trace = detail::default_wants_trace<Processor>::value;
+
+    /**
+     * The table backend with which to decode for the processor. This is one of
+     * table_backend_wide, table_backend_packed, table_backend_classes, or
+     * table_backend_fused.
+     *
+     * By default, this is table_backend_fused unless the processor declares a
+     * table_backend member type to the contrary.
+     */
+    using table_backend = typename detail::default_table_backend<Processor>::type;
+
+    /**
+     * Whether none of the hooks of the processor throw. If so, decoding for
+     * the processor is noexcept.
+     *
+     * By default, this is true for a static processor whose hooks are all
+     * declared noexcept. The hooks of static_processor are. This is always
+     * false for a virtual processor.
+     */
+    static constexpr bool nothrow = detail::default_nothrow<Processor>();
+};
+
+/**
+ * Adapts a virtual processor to the static processor interface. Every hook
+ * forwards to its virtual counterpart, so existing processors keep working.
+ *
+ * @tparam Processor The virtual processor type
+ */
+template<class Processor>
+class processor_adapter : public static_processor<processor_adapter<Processor>>
+{
+    /** The adapted processor. */
+    Processor& m_proc;
+
+public:
+    explicit processor_adapter(Processor& p_proc)
+            : m_proc {p_proc}
+    {
+    }
+
+    void print(char32_t c)
+    { m_proc.print(c); }
+
+    void print_run(std::string_view str)
+    { static_cast<processor&>(m_proc).print_run(str); }
+
+    void print_run(std::u32string_view str)
+    { static_cast<processor&>(m_proc).print_run(str); }
+
+    void ctl(char c)
+    { m_proc.ctl(c); }
+
+    void ctl_begin()
+    { m_proc.ctl_begin(); }
+
+    void ctl_put(char32_t c)
+    { m_proc.ctl_put(c); }
+
+    void csi_dispatch(const csi_sequence& seq, char final)
+    { m_proc.csi_dispatch(seq, final); }
+
+    void ctl_end(bool cancel)
+    { m_proc.ctl_end(cancel); }
+
+    void dcs_begin()
+    { m_proc.dcs_begin(); }
+
+    void dcs_hook(const csi_sequence& seq, char final)
+    { m_proc.dcs_hook(seq, final); }
+
+    void dcs_put(char32_t c)
+    { m_proc.dcs_put(c); }
+
+    void dcs_data(std::string_view str)
+    { static_cast<processor&>(m_proc).dcs_data(str); }
+
+    void dcs_end(bool cancel)
+    { m_proc.dcs_end(cancel); }
+
+    void osc_begin()
+    { m_proc.osc_begin(); }
+
+    void osc_put(char32_t c)
+    { m_proc.osc_put(c); }
+
+    void osc_data(std::string_view str)
+    { static_cast<processor&>(m_proc).osc_data(str); }
+
+    void osc_end(bool cancel)
+    { m_proc.osc_end(cancel); }
+
+    void decode_begin()
+    { m_proc.decode_begin(); }
+
+    void decode_put(char32_t c)
+    { m_proc.decode_put(c); }
+
+    void decode_action(int act)
+    { m_proc.decode_action(act); }
+
+    void decode_transition(int src, int dst)
+    { m_proc.decode_transition(src, dst); }
+
+    void decode_end(bool cancel)
+    { m_proc.decode_end(cancel); }
+};
+
+/**
+ * An adapted processor shares the traits of the processor it adapts.
+ *
+ * @tparam Processor The virtual processor type
+ */
+template<class Processor>
+struct processor_traits<processor_adapter<Processor>> : processor_traits<std::remove_cv_t<Processor>>
+{
+};
+
 } // namespace vtdec
 
 #endif // #ifndef VTDEC_PROCESSOR_H
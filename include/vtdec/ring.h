@@ -0,0 +1,277 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+#ifndef VTDEC_RING_H
+#define VTDEC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+#include <vtdec/decoder.h>
+
+namespace vtdec
+{
+
+/**
+ * A view of the bytes in a ring, in order. Where they wrap around the end of
+ * the ring, they are split in two.
+ */
+struct ring_view
+{
+    /** The first span. */
+    std::string_view first;
+
+    /** The second span, empty unless the bytes wrap around. */
+    std::string_view second;
+
+    /**
+     * @return The total number of bytes
+     */
+    std::size_t size() const
+    { return first.size() + second.size(); }
+
+    /**
+     * @return True if there are no bytes, otherwise false
+     */
+    bool empty() const
+    { return size() == 0; }
+};
+
+/**
+ * A view of the free space in a ring, in order. Where it wraps around the end
+ * of the ring, it is split in two, e.g. for a readv.
+ */
+struct ring_space
+{
+    /** The first span. */
+    char* first;
+
+    /** The size of the first span. */
+    std::size_t first_size;
+
+    /** The second span. */
+    char* second;
+
+    /** The size of the second span, zero unless the space wraps around. */
+    std::size_t second_size;
+
+    /**
+     * @return The total number of bytes
+     */
+    std::size_t size() const
+    { return first_size + second_size; }
+};
+
+/**
+ * A bounded, lock-free ring of bytes between one producer thread and one
+ * consumer thread, e.g. a PTY reader and a decoder. Neither side ever waits
+ * on the other. A side that finds the ring full or empty comes back later,
+ * however it likes.
+ *
+ * Each side owns one position and only reads the other, so each position has
+ * a cache line of its own. The producer, which tends to write in small
+ * pieces, caches the last tail it read and only looks again once the space
+ * seems low. The consumer looks at the head on every peek, which is cheap
+ * next to decoding what it finds.
+ */
+class byte_ring
+{
+    /** The storage. */
+    std::unique_ptr<char[]> m_data;
+
+    /** The capacity, a power of two. */
+    std::size_t m_capacity;
+
+    /** The total number of bytes ever written. Written by the producer. */
+    alignas(64) std::atomic<std::size_t> m_head;
+
+    /** The producer's last look at the tail. */
+    std::size_t m_tail_cache;
+
+    /** The total number of bytes ever read. Written by the consumer. */
+    alignas(64) std::atomic<std::size_t> m_tail;
+
+    /**
+     * Internal. Round up to a power of two.
+     */
+    static std::size_t round_up(std::size_t n)
+    {
+        std::size_t p = 1;
+
+        while (p < n)
+        {
+            p <<= 1;
+        }
+
+        return p;
+    }
+
+public:
+    /**
+     * Create a ring.
+     *
+     * @param p_capacity The minimum capacity in bytes, rounded up to a power of two
+     */
+    explicit byte_ring(std::size_t p_capacity)
+            : m_data {new char[round_up(p_capacity)]}
+            , m_capacity {round_up(p_capacity)}
+            , m_head {0}
+            , m_tail_cache {0}
+            , m_tail {0}
+    {
+    }
+
+    byte_ring(const byte_ring&) = delete;
+
+    byte_ring& operator=(const byte_ring&) = delete;
+
+    /**
+     * @return The capacity in bytes
+     */
+    std::size_t capacity() const
+    { return m_capacity; }
+
+    /**
+     * Producer only. Get the free space, to be filled in place and then
+     * committed.
+     *
+     * @return The free space
+     */
+    ring_space prepare()
+    {
+        auto head = m_head.load(std::memory_order_relaxed);
+
+        // Look again once the space seems low, as the consumer has likely freed more by now
+        if (head - m_tail_cache > m_capacity / 2)
+        {
+            m_tail_cache = m_tail.load(std::memory_order_acquire);
+        }
+
+        auto free = m_capacity - (head - m_tail_cache);
+        auto offset = head & (m_capacity - 1);
+        auto first = free < m_capacity - offset ? free : m_capacity - offset;
+
+        return {m_data.get() + offset, first, m_data.get(), free - first};
+    }
+
+    /**
+     * Producer only. Hand bytes written into the free space over to the
+     * consumer.
+     *
+     * @param n The number of bytes, no more than the free space
+     */
+    void commit(std::size_t n)
+    { m_head.store(m_head.load(std::memory_order_relaxed) + n, std::memory_order_release); }
+
+    /**
+     * Producer only. Copy bytes into the ring, as many as fit.
+     *
+     * @param data A pointer to the bytes
+     * @param size The number of bytes
+     * @return The number of bytes copied
+     */
+    std::size_t write(const char* data, std::size_t size)
+    {
+        auto space = prepare();
+
+        if (space.size() < size)
+        {
+            m_tail_cache = m_tail.load(std::memory_order_acquire);
+            space = prepare();
+        }
+
+        auto n = size < space.size() ? size : space.size();
+        auto first = n < space.first_size ? n : space.first_size;
+
+        std::memcpy(space.first, data, first);
+        std::memcpy(space.second, data + first, n - first);
+
+        commit(n);
+        return n;
+    }
+
+    /**
+     * Consumer only. Get the bytes in the ring, to be read in place and then
+     * consumed.
+     *
+     * @return The bytes
+     */
+    ring_view peek()
+    {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        auto used = m_head.load(std::memory_order_acquire) - tail;
+        auto offset = tail & (m_capacity - 1);
+        auto first = used < m_capacity - offset ? used : m_capacity - offset;
+
+        return {{m_data.get() + offset, first}, {m_data.get(), used - first}};
+    }
+
+    /**
+     * Consumer only. Hand bytes that were read back over to the producer.
+     *
+     * @param n The number of bytes, no more than were peeked
+     */
+    void consume(std::size_t n)
+    { m_tail.store(m_tail.load(std::memory_order_relaxed) + n, std::memory_order_release); }
+};
+
+/**
+ * Consumer only. Decode everything in a ring, in place, and hand the space
+ * back to the producer. Bytes that wrap around the end of the ring are fed as
+ * two chunks. The decoder carries any unfinished sequence from one to the
+ * next, and from one drain to the next, so the processor sees the same thing
+ * as if the stream had come in one piece.
+ *
+ * @tparam Processor The processor type
+ * @tparam Config The config type
+ * @param ring The ring
+ * @param dec The decoder
+ * @return The number of bytes decoded
+ */
+template<class Processor, class Config>
+std::size_t drain(byte_ring& ring, decoder<Processor, Config>& dec)
+{
+    auto view = ring.peek();
+
+    if (view.empty())
+    {
+        return 0;
+    }
+
+    dec.feed(view.first);
+    dec.feed(view.second);
+    ring.consume(view.size());
+
+    return view.size();
+}
+
+} // namespace vtdec
+
+#endif // #ifndef VTDEC_RING_H
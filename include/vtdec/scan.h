@@ -0,0 +1,302 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+#ifndef VTDEC_SCAN_H
+#define VTDEC_SCAN_H
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VTDEC_SCAN_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define VTDEC_SCAN_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace vtdec
+{
+
+/**
+ * Implementation details.
+ */
+namespace detail
+{
+
+/**
+ * Internal. Count the trailing zero bits of a nonzero integer.
+ */
+inline int count_trailing_zeros(std::uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<int>(index);
+#else
+    int n = 0;
+    while (!(x & 1))
+    {
+        x >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+/**
+ * Internal. Flag the zero octets of a word in their high bits. Borrows only
+ * carry upward from flagged octets, so the lowest flag is always exact.
+ */
+constexpr std::uint64_t swar_zeros(std::uint64_t x)
+{
+    return (x - 0x0101010101010101) & ~x & 0x8080808080808080;
+}
+
+/**
+ * Internal. Flag the octets of a word equal to a value in their high bits.
+ */
+constexpr std::uint64_t swar_equal(std::uint64_t x, unsigned char value)
+{
+    return swar_zeros(x ^ (0x0101010101010101 * value));
+}
+
+/**
+ * Internal. Stop at octets that are not plain text. Plain text is everything
+ * from 0x20 to 0x7e, inclusive.
+ */
+struct text_stops
+{
+    static constexpr bool scalar(unsigned char c)
+    { return c < 0x20 || c >= 0x7f; }
+
+    static constexpr std::uint64_t swar(std::uint64_t x)
+    { return (((x - 0x2020202020202020) & ~x) | x | swar_equal(x, 0x7f)) & 0x8080808080808080; }
+
+#if defined(VTDEC_SCAN_SSE2)
+    static int sse2(__m128i v)
+    {
+        // Signed comparison catches octets at least 0x80 along with the C0 controls
+        return _mm_movemask_epi8(_mm_or_si128(_mm_cmplt_epi8(v, _mm_set1_epi8(0x20)),
+                _mm_cmpeq_epi8(v, _mm_set1_epi8(0x7f))));
+    }
+#endif
+
+#if defined(VTDEC_SCAN_AVX2)
+    static int avx2(__m256i v)
+    {
+        // Signed comparison catches octets at least 0x80 along with the C0 controls
+        return _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(0x20), v),
+                _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x7f))));
+    }
+#endif
+};
+
+/**
+ * Internal. Stop at octets that may end device control string (DCS) data:
+ * CAN (0x18), SUB (0x1a), ESC (0x1b), DEL (0x7f), and everything at least 0x80,
+ * which includes ST (0x9c).
+ */
+struct dcs_stops
+{
+    static constexpr bool scalar(unsigned char c)
+    { return c == 0x18 || c == 0x1a || c == 0x1b || c >= 0x7f; }
+
+    static constexpr std::uint64_t swar(std::uint64_t x)
+    {
+        return (x & 0x8080808080808080) | swar_equal(x, 0x18) | swar_equal(x, 0x1a)
+                | swar_equal(x, 0x1b) | swar_equal(x, 0x7f);
+    }
+
+#if defined(VTDEC_SCAN_SSE2)
+    static int sse2(__m128i v)
+    {
+        // Setting bit 1 folds CAN onto SUB
+        auto flags = _mm_or_si128(_mm_cmpeq_epi8(_mm_or_si128(v, _mm_set1_epi8(0x02)), _mm_set1_epi8(0x1a)),
+                _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(0x1b)), _mm_cmpeq_epi8(v, _mm_set1_epi8(0x7f))));
+        return _mm_movemask_epi8(_mm_or_si128(flags, v));
+    }
+#endif
+
+#if defined(VTDEC_SCAN_AVX2)
+    static int avx2(__m256i v)
+    {
+        // Setting bit 1 folds CAN onto SUB
+        auto flags = _mm256_or_si256(
+                _mm256_cmpeq_epi8(_mm256_or_si256(v, _mm256_set1_epi8(0x02)), _mm256_set1_epi8(0x1a)),
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x1b)),
+                        _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x7f))));
+        return _mm256_movemask_epi8(_mm256_or_si256(flags, v));
+    }
+#endif
+};
+
+/**
+ * Internal. Scan for the first stop octet, one at a time.
+ */
+template<class Stops>
+const char* scan_scalar(const char* begin, const char* end)
+{
+    while (begin != end && !Stops::scalar(static_cast<unsigned char>(*begin)))
+    {
+        ++begin;
+    }
+
+    return begin;
+}
+
+/**
+ * Internal. Scan for the first stop octet, eight at a time.
+ */
+template<class Stops>
+const char* scan_swar(const char* begin, const char* end)
+{
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_MSC_VER)
+    while (end - begin >= 8)
+    {
+        std::uint64_t x;
+        std::memcpy(&x, begin, sizeof(x));
+
+        if (auto flags = Stops::swar(x))
+        {
+            return begin + count_trailing_zeros(flags) / 8;
+        }
+
+        begin += 8;
+    }
+#endif
+
+    return scan_scalar<Stops>(begin, end);
+}
+
+#if defined(VTDEC_SCAN_SSE2)
+
+/**
+ * Internal. Scan for the first stop octet, sixteen at a time.
+ */
+template<class Stops>
+const char* scan_sse2(const char* begin, const char* end)
+{
+    while (end - begin >= 16)
+    {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+
+        if (auto flags = Stops::sse2(v))
+        {
+            return begin + count_trailing_zeros(static_cast<unsigned>(flags));
+        }
+
+        begin += 16;
+    }
+
+    return scan_swar<Stops>(begin, end);
+}
+
+#endif
+
+#if defined(VTDEC_SCAN_AVX2)
+
+/**
+ * Internal. Scan for the first stop octet, 32 at a time.
+ */
+template<class Stops>
+const char* scan_avx2(const char* begin, const char* end)
+{
+    while (end - begin >= 32)
+    {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+
+        if (auto flags = Stops::avx2(v))
+        {
+            return begin + count_trailing_zeros(static_cast<unsigned>(flags));
+        }
+
+        begin += 32;
+    }
+
+    return scan_sse2<Stops>(begin, end);
+}
+
+#endif
+
+/**
+ * Internal. Scan for the first stop octet with the widest vector instructions
+ * enabled at compile time.
+ */
+template<class Stops>
+const char* scan(const char* begin, const char* end)
+{
+#if defined(VTDEC_SCAN_AVX2)
+    return scan_avx2<Stops>(begin, end);
+#elif defined(VTDEC_SCAN_SSE2)
+    return scan_sse2<Stops>(begin, end);
+#else
+    return scan_swar<Stops>(begin, end);
+#endif
+}
+
+} // namespace detail
+
+/**
+ * Scan for the first octet that is not plain text. That is, find the next
+ * octet below 0x20, equal to 0x7f, or at least 0x80. The widest vector
+ * instructions enabled at compile time are used.
+ *
+ * @param begin A pointer to the first octet
+ * @param end A pointer one past the last octet
+ * @return A pointer to the first such octet, or end if there is none
+ */
+inline const char* scan_text(const char* begin, const char* end)
+{
+    return detail::scan<detail::text_stops>(begin, end);
+}
+
+/**
+ * Scan for the first octet that may end device control string (DCS) data.
+ * That is, find the next CAN, SUB, ESC, or DEL, or octet at least 0x80. The
+ * widest vector instructions enabled at compile time are used.
+ *
+ * @param begin A pointer to the first octet
+ * @param end A pointer one past the last octet
+ * @return A pointer to the first such octet, or end if there is none
+ */
+inline const char* scan_dcs(const char* begin, const char* end)
+{
+    return detail::scan<detail::dcs_stops>(begin, end);
+}
+
+} // namespace vtdec
+
+#endif // #ifndef VTDEC_SCAN_H
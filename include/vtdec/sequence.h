@@ -0,0 +1,100 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+#ifndef VTDEC_SEQUENCE_H
+#define VTDEC_SEQUENCE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vtdec
+{
+
+/**
+ * The parsed parameters, intermediates, and private marker of a control
+ * sequence (CSI) or device control string (DCS). Storage is fixed, so parsing
+ * never allocates.
+ *
+ * As in xterm, parameters beyond the capacity are dropped and parameter values
+ * saturate at 65535.
+ */
+struct csi_sequence
+{
+    /** The maximum number of parameters. */
+    static constexpr std::size_t max_params = 32;
+
+    /** The maximum number of intermediates. */
+    static constexpr std::size_t max_intermediates = 2;
+
+    /** The maximum parameter value. */
+    static constexpr std::uint16_t max_value = 65535;
+
+    /** The parameter values. Empty parameters are zero. */
+    std::uint16_t params[max_params];
+
+    /** A bit for each parameter, set if it is a sub-parameter (i.e. follows a colon). */
+    std::uint32_t subparams;
+
+    /** The number of parameters. */
+    std::uint8_t param_count;
+
+    /** The number of intermediates. */
+    std::uint8_t intermediate_count;
+
+    /** The intermediates. */
+    char intermediates[max_intermediates];
+
+    /** The private marker (one of '<', '=', '>', or '?'), or zero if none. */
+    char private_marker;
+
+    /** True if parameters or intermediates were dropped, otherwise false. */
+    bool overflow;
+
+    /**
+     * Get a parameter value, falling back on a default if it is empty or
+     * missing.
+     *
+     * @param index The parameter index
+     * @param fallback The default value (optional)
+     * @return The parameter value
+     */
+    constexpr std::uint16_t param(std::size_t index, std::uint16_t fallback = 0) const
+    { return index < param_count && params[index] ? params[index] : fallback; }
+
+    /**
+     * Test whether a parameter is a sub-parameter (i.e. follows a colon).
+     *
+     * @param index The parameter index
+     * @return True if such is the case, otherwise false
+     */
+    constexpr bool is_subparam(std::size_t index) const
+    { return index < param_count && (subparams >> index & 1); }
+};
+
+} // namespace vtdec
+
+#endif // #ifndef VTDEC_SEQUENCE_H
@@ -0,0 +1,333 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+#ifndef VTDEC_SESSION_H
+#define VTDEC_SESSION_H
+
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <vtdec/decode.h>
+
+namespace vtdec
+{
+
+/**
+ * One piece of a batch of input for a session pool.
+ */
+struct session_input
+{
+    /** The index of the session. */
+    std::size_t session;
+
+    /** A view of the UTF-8 input. */
+    std::string_view data;
+};
+
+/**
+ * A pool of decoding sessions, each with a processor of its own, meant for a
+ * server juggling many terminals at once. Input for many sessions is fed in
+ * one batch, and decoded in one pass with the decoding tables kept hot.
+ *
+ * Each session behaves like a decoder: the processor is told a decode
+ * operation began the first time the session is fed, and that it ended when
+ * the session is flushed or finished. So a session fed once per read sees one
+ * decode_begin and decode_end over many reads, not one each time.
+ *
+ * The state of all sessions is kept as parallel arrays. The few fields needed
+ * to resume a session are kept apart from the parameters of unfinished control
+ * sequences, which are copied in and out only for a session that was cut off
+ * in the middle of one.
+ *
+ * Processors are held by value and addressed by session index. They are not
+ * required to be static processors, but a static processor may be called
+ * without going through a virtual table.
+ *
+ * Different sessions may be fed from different threads at the same time, as
+ * they share nothing. The sessions must all be opened beforehand.
+ *
+ * @tparam Processor The processor type
+ * @tparam Config The config type (optional)
+ */
+template<class Processor, class Config = decode_config>
+class session_pool : private Config
+{
+    static_assert(is_processor_v<Processor>, "parameter 'Processor' not a vtdec::processor");
+
+    /** The processors, one per session. */
+    std::vector<Processor> m_procs;
+
+    /** The index of the current state of each session. */
+    std::vector<int> m_states;
+
+    /** The index of the current sequence of each session. */
+    std::vector<int> m_sequences;
+
+    /** The bits of a partially-decoded UTF-8 codepoint for each session. */
+    std::vector<char32_t> m_utf8_codepoints;
+
+    /** The number of UTF-8 continuation octets still expected for each session. */
+    std::vector<unsigned char> m_utf8_remaining;
+
+    /** The total number of octets in the current UTF-8 sequence for each session. */
+    std::vector<unsigned char> m_utf8_lengths;
+
+    /** The number of codepoints passed along so far for the current sequence of each session. */
+    std::vector<std::size_t> m_lengths;
+
+    /** True for each session whose processor has been told a decode operation began. */
+    std::vector<unsigned char> m_begun;
+
+    /** The parameters of the current control sequence of each session. Only valid mid-sequence. */
+    std::vector<csi_sequence> m_csi;
+
+    /**
+     * Internal. Determine if a state needs its parameters carried over. They
+     * are cleared when a sequence begins, so in the ground state with no
+     * sequence open, they are dead.
+     */
+    static bool mid_sequence(int state, int sequence)
+    { return state != vtdec::state::ground || sequence != detail::sequence::idk; }
+
+    /**
+     * Internal. Gather the state of a session.
+     */
+    void load(std::size_t i, decode_state& s) const
+    {
+        s.state = m_states[i];
+        s.sequence = m_sequences[i];
+        s.utf8_codepoint = m_utf8_codepoints[i];
+        s.utf8_remaining = m_utf8_remaining[i];
+        s.utf8_length = m_utf8_lengths[i];
+        s.length = m_lengths[i];
+
+        if (mid_sequence(s.state, s.sequence))
+        {
+            s.csi = m_csi[i];
+        }
+    }
+
+    /**
+     * Internal. Scatter the state of a session.
+     */
+    void store(std::size_t i, const decode_state& s)
+    {
+        m_states[i] = s.state;
+        m_sequences[i] = s.sequence;
+        m_utf8_codepoints[i] = s.utf8_codepoint;
+        m_utf8_remaining[i] = s.utf8_remaining;
+        m_utf8_lengths[i] = s.utf8_length;
+        m_lengths[i] = s.length;
+
+        if (mid_sequence(s.state, s.sequence))
+        {
+            m_csi[i] = s.csi;
+        }
+    }
+
+public:
+    /**
+     * Create an empty pool.
+     *
+     * @param p_config The config (optional)
+     */
+    explicit session_pool(const Config& p_config = {})
+            : Config {p_config}
+    {
+    }
+
+    /**
+     * @return The config
+     */
+    const Config& config() const
+    { return *this; }
+
+    /**
+     * @return The number of sessions
+     */
+    std::size_t size() const
+    { return m_procs.size(); }
+
+    /**
+     * Reserve room for a number of sessions.
+     *
+     * @param n The number of sessions
+     */
+    void reserve(std::size_t n)
+    {
+        m_procs.reserve(n);
+        m_states.reserve(n);
+        m_sequences.reserve(n);
+        m_utf8_codepoints.reserve(n);
+        m_utf8_remaining.reserve(n);
+        m_utf8_lengths.reserve(n);
+        m_lengths.reserve(n);
+        m_begun.reserve(n);
+        m_csi.reserve(n);
+    }
+
+    /**
+     * Open a new session. Its processor is constructed in place.
+     *
+     * @param args The arguments for the processor constructor
+     * @return The index of the session
+     */
+    template<class... Args>
+    std::size_t open(Args&&... args)
+    {
+        m_procs.emplace_back(std::forward<Args>(args)...);
+        m_states.push_back(vtdec::state::ground);
+        m_sequences.push_back(detail::sequence::idk);
+        m_utf8_codepoints.push_back(0);
+        m_utf8_remaining.push_back(0);
+        m_utf8_lengths.push_back(0);
+        m_lengths.push_back(0);
+        m_begun.push_back(false);
+        m_csi.emplace_back();
+        return m_procs.size() - 1;
+    }
+
+    /**
+     * @param i The index of the session
+     * @return The processor of the session
+     */
+    Processor& target(std::size_t i)
+    { return m_procs[i]; }
+
+    /**
+     * @param i The index of the session
+     * @return The processor of the session
+     */
+    const Processor& target(std::size_t i) const
+    { return m_procs[i]; }
+
+    /**
+     * @param i The index of the session
+     * @return The state of the session
+     */
+    decode_state state(std::size_t i) const
+    {
+        decode_state s {};
+        load(i, s);
+        return s;
+    }
+
+    /**
+     * Feed a chunk of UTF-8 input to one session.
+     *
+     * @param i The index of the session
+     * @param str A view of the chunk
+     */
+    void feed(std::size_t i, std::string_view str) noexcept(processor_traits<Processor>::nothrow)
+    {
+        VTDEC_ASSERT(i < m_procs.size());
+
+        auto&& p = detail::dispatch(m_procs[i]);
+
+        if (!m_begun[i])
+        {
+            p.decode_begin();
+            m_begun[i] = true;
+        }
+
+        decode_state s;
+        load(i, s);
+        detail::put_utf8(str, p, s, config());
+        store(i, s);
+    }
+
+    /**
+     * Feed a batch of input to the sessions in one pass. Pieces for the same
+     * session are decoded in the order given.
+     *
+     * @tparam InputIter The input iterator type, over session_input
+     * @param begin An iterator to the beginning of the batch
+     * @param end An iterator to the end of the batch
+     */
+    template<class InputIter>
+    void feed(InputIter begin, InputIter end) noexcept(processor_traits<Processor>::nothrow)
+    {
+        for (; begin != end; ++begin)
+        {
+            const session_input& in = *begin;
+            feed(in.session, in.data);
+        }
+    }
+
+    /**
+     * Flush the end of the stream for one session and finish it, as for a
+     * decoder. The session is then ready for a new stream.
+     *
+     * @param i The index of the session
+     */
+    void flush(std::size_t i) noexcept(processor_traits<Processor>::nothrow)
+    {
+        VTDEC_ASSERT(i < m_procs.size());
+
+        if (m_utf8_remaining[i] != 0 || mid_sequence(m_states[i], m_sequences[i]))
+        {
+            auto&& p = detail::dispatch(m_procs[i]);
+
+            if (!m_begun[i])
+            {
+                p.decode_begin();
+                m_begun[i] = true;
+            }
+
+            decode_state s;
+            load(i, s);
+            detail::put_end(p, s, config());
+            store(i, s);
+        }
+
+        finish(i);
+    }
+
+    /**
+     * Finish the current decode operation of one session, if one began. Any
+     * unfinished sequence is left as it is, so feeding may resume afterward.
+     *
+     * @param i The index of the session
+     */
+    void finish(std::size_t i) noexcept(processor_traits<Processor>::nothrow)
+    {
+        VTDEC_ASSERT(i < m_procs.size());
+
+        if (m_begun[i])
+        {
+            detail::dispatch(m_procs[i]).decode_end(false);
+            m_begun[i] = false;
+        }
+    }
+};
+
+} // namespace vtdec
+
+#endif // #ifndef VTDEC_SESSION_H
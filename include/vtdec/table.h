@@ -29,6 +29,8 @@
 #define VTDEC_TABLE_H
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <utility>
 
 #include <vtdec/action.h>
@@ -268,9 +270,7 @@ struct table_row_plan<state::csi_entry>
      * 0x1c..0x1f => :execute,
      * 0x7f       => :ignore,
      * 0x20..0x2f => [:collect, transition_to(:CSI_INTERMEDIATE)],
-     * 0x3a       => transition_to(:CSI_IGNORE),
-     * 0x30..0x39 => [:param, transition_to(:CSI_PARAM)],
-     * 0x3b       => [:param, transition_to(:CSI_PARAM)],
+     * 0x30..0x3b => [:param, transition_to(:CSI_PARAM)],
      * 0x3c..0x3f => [:collect, transition_to(:CSI_PARAM)],
      * 0x40..0x7e => [:csi_dispatch, transition_to(:GROUND)]
      */
@@ -283,9 +283,7 @@ struct table_row_plan<state::csi_entry>
             std::pair {table_range {0x1c, 0x1f}, table_predicate {action::execute, state::none}},
             std::pair {table_range {0x7f, 0x7f}, table_predicate {action::ignore, state::none}},
             std::pair {table_range {0x20, 0x2f}, table_predicate {action::collect, state::csi_intermediate}},
-            std::pair {table_range {0x3a, 0x3a}, table_predicate {action::none, state::csi_ignore}},
-            std::pair {table_range {0x30, 0x39}, table_predicate {action::param, state::csi_param}},
-            std::pair {table_range {0x3b, 0x3b}, table_predicate {action::param, state::csi_param}},
+            std::pair {table_range {0x30, 0x3b}, table_predicate {action::param, state::csi_param}},
             std::pair {table_range {0x3c, 0x3f}, table_predicate {action::collect, state::csi_param}},
             std::pair {table_range {0x40, 0x7e}, table_predicate {action::csi_dispatch, state::ground}},
     };
@@ -303,10 +301,8 @@ struct table_row_plan<state::csi_param>
      * 0x00..0x17 => :execute,
      * 0x19       => :execute,
      * 0x1c..0x1f => :execute,
-     * 0x30..0x39 => :param,
-     * 0x3b       => :param,
+     * 0x30..0x3b => :param,
      * 0x7f       => :ignore,
-     * 0x3a       => transition_to(:CSI_IGNORE),
      * 0x3c..0x3f => transition_to(:CSI_IGNORE),
      * 0x20..0x2f => [:collect, transition_to(:CSI_INTERMEDIATE)],
      * 0x40..0x7e => [:csi_dispatch, transition_to(:GROUND)]
@@ -318,10 +314,8 @@ struct table_row_plan<state::csi_param>
             std::pair {table_range {0x00, 0x17}, table_predicate {action::execute, state::none}},
             std::pair {table_range {0x19, 0x19}, table_predicate {action::execute, state::none}},
             std::pair {table_range {0x1c, 0x1f}, table_predicate {action::execute, state::none}},
-            std::pair {table_range {0x30, 0x39}, table_predicate {action::param, state::none}},
-            std::pair {table_range {0x3b, 0x3b}, table_predicate {action::param, state::none}},
+            std::pair {table_range {0x30, 0x3b}, table_predicate {action::param, state::none}},
             std::pair {table_range {0x7f, 0x7f}, table_predicate {action::ignore, state::none}},
-            std::pair {table_range {0x3a, 0x3a}, table_predicate {action::none, state::csi_ignore}},
             std::pair {table_range {0x3c, 0x3f}, table_predicate {action::none, state::csi_ignore}},
             std::pair {table_range {0x20, 0x2f}, table_predicate {action::collect, state::csi_intermediate}},
             std::pair {table_range {0x40, 0x7e}, table_predicate {action::csi_dispatch, state::ground}},
@@ -402,10 +396,8 @@ struct table_row_plan<state::dcs_entry>
      * 0x19       => :ignore,
      * 0x1c..0x1f => :ignore,
      * 0x7f       => :ignore,
-     * 0x3a       => transition_to(:DCS_IGNORE),
      * 0x20..0x2f => [:collect, transition_to(:DCS_INTERMEDIATE)],
-     * 0x30..0x39 => [:param, transition_to(:DCS_PARAM)],
-     * 0x3b       => [:param, transition_to(:DCS_PARAM)],
+     * 0x30..0x3b => [:param, transition_to(:DCS_PARAM)],
      * 0x3c..0x3f => [:collect, transition_to(:DCS_PARAM)],
      * 0x40..0x7e => [transition_to(:DCS_PASSTHROUGH)]
      */
@@ -417,10 +409,8 @@ struct table_row_plan<state::dcs_entry>
             std::pair {table_range {0x19, 0x19}, table_predicate {action::ignore, state::none}},
             std::pair {table_range {0x1c, 0x1f}, table_predicate {action::ignore, state::none}},
             std::pair {table_range {0x7f, 0x7f}, table_predicate {action::ignore, state::none}},
-            std::pair {table_range {0x3a, 0x3a}, table_predicate {action::none, state::dcs_ignore}},
             std::pair {table_range {0x20, 0x2f}, table_predicate {action::collect, state::dcs_intermediate}},
-            std::pair {table_range {0x30, 0x39}, table_predicate {action::param, state::dcs_param}},
-            std::pair {table_range {0x3b, 0x3b}, table_predicate {action::param, state::dcs_param}},
+            std::pair {table_range {0x30, 0x3b}, table_predicate {action::param, state::dcs_param}},
             std::pair {table_range {0x3c, 0x3f}, table_predicate {action::collect, state::dcs_param}},
             std::pair {table_range {0x40, 0x7e}, table_predicate {action::none, state::dcs_passthrough}},
     };
@@ -438,10 +428,8 @@ struct table_row_plan<state::dcs_param>
      * 0x00..0x17 => :ignore,
      * 0x19       => :ignore,
      * 0x1c..0x1f => :ignore,
-     * 0x30..0x39 => :param,
-     * 0x3b       => :param,
+     * 0x30..0x3b => :param,
      * 0x7f       => :ignore,
-     * 0x3a       => transition_to(:DCS_IGNORE),
      * 0x3c..0x3f => transition_to(:DCS_IGNORE),
      * 0x20..0x2f => [:collect, transition_to(:DCS_INTERMEDIATE)],
      * 0x40..0x7e => transition_to(:DCS_PASSTHROUGH)
@@ -453,10 +441,8 @@ struct table_row_plan<state::dcs_param>
             std::pair {table_range {0x00, 0x17}, table_predicate {action::ignore, state::none}},
             std::pair {table_range {0x19, 0x19}, table_predicate {action::ignore, state::none}},
             std::pair {table_range {0x1c, 0x1f}, table_predicate {action::ignore, state::none}},
-            std::pair {table_range {0x30, 0x39}, table_predicate {action::param, state::none}},
-            std::pair {table_range {0x3b, 0x3b}, table_predicate {action::param, state::none}},
+            std::pair {table_range {0x30, 0x3b}, table_predicate {action::param, state::none}},
             std::pair {table_range {0x7f, 0x7f}, table_predicate {action::ignore, state::none}},
-            std::pair {table_range {0x3a, 0x3a}, table_predicate {action::none, state::dcs_ignore}},
             std::pair {table_range {0x3c, 0x3f}, table_predicate {action::none, state::dcs_ignore}},
             std::pair {table_range {0x20, 0x2f}, table_predicate {action::collect, state::dcs_intermediate}},
             std::pair {table_range {0x40, 0x7e}, table_predicate {action::none, state::dcs_passthrough}},
@@ -600,6 +586,18 @@ struct table_row_plan<state::sos_pm_apc_string>
     };
 };
 
+/**
+ * The predicates to execute on entering and leaving a state.
+ */
+struct table_event_predicates
+{
+    /** The predicate to execute on entering the state. */
+    table_predicate enter;
+
+    /** The predicate to execute on leaving the state. */
+    table_predicate leave;
+};
+
 /**
  * Build a table row for a state according to plan.
  *
@@ -609,25 +607,25 @@ struct table_row_plan<state::sos_pm_apc_string>
 template<int StateIndex>
 static constexpr auto table_build_row()
 {
-    // We need to fit 128 ASCII characters and two event codes in the row
-    constexpr int width = 128 + 2;
+    // We need to fit all 256 octets in the row
+    constexpr int width = 256;
 
     // The new row
     std::array<table_predicate, width> row {};
 
-    // Map enter and leave events for plan of interest
-    row[128] = table_row_plan_on_enter<StateIndex>;
-    row[129] = table_row_plan_on_leave<StateIndex>;
-
-    // Now map ASCII characters
-    for (int c = 0; c < 128; ++c)
+    // Now map octets
+    for (int c = 0; c < width; ++c)
     {
+        // The plans cover C0, GL, and C1 only
+        // GR octets (0xa0 to 0xff) behave just like their GL counterparts
+        int key = c >= 0xa0 ? c - 0x80 : c;
+
         // Generic algorithm for mapping characters
-        auto map = [&row, c](auto&& plan) -> bool
+        auto map = [&row, c, key](auto&& plan) -> bool
         {
             for (auto&&[range, predicate] : plan)
             {
-                if (range.contains(c))
+                if (range.contains(key))
                 {
                     row[c] = predicate;
                     return true;
@@ -649,7 +647,19 @@ static constexpr auto table_build_row()
 }
 
 /**
- * The state transition table.
+ * Build the enter and leave predicates for a state according to plan.
+ *
+ * @tparam StateIndex The state index
+ * @return The built predicates
+ */
+template<int StateIndex>
+static constexpr auto table_build_events()
+{
+    return table_event_predicates {table_row_plan_on_enter<StateIndex>, table_row_plan_on_leave<StateIndex>};
+}
+
+/**
+ * The state transition table. Index by state, then by unsigned octet.
  */
 static constexpr auto table = std::array {
         table_build_row<state::ground>(),
@@ -668,6 +678,590 @@ static constexpr auto table = std::array {
         table_build_row<state::sos_pm_apc_string>(),
 };
 
+/**
+ * The state enter and leave events. Index by state.
+ */
+static constexpr auto table_events = std::array {
+        table_build_events<state::ground>(),
+        table_build_events<state::escape>(),
+        table_build_events<state::escape_intermediate>(),
+        table_build_events<state::csi_entry>(),
+        table_build_events<state::csi_param>(),
+        table_build_events<state::csi_intermediate>(),
+        table_build_events<state::csi_ignore>(),
+        table_build_events<state::dcs_entry>(),
+        table_build_events<state::dcs_param>(),
+        table_build_events<state::dcs_intermediate>(),
+        table_build_events<state::dcs_passthrough>(),
+        table_build_events<state::dcs_ignore>(),
+        table_build_events<state::osc_string>(),
+        table_build_events<state::sos_pm_apc_string>(),
+};
+
+/**
+ * Test whether an action may be carried out in a state. Some actions take
+ * their meaning from the state, so the decoder knows how to carry them out
+ * only in certain states.
+ *
+ * @param act The action index
+ * @param state The state index
+ * @return True if such is the case, otherwise false
+ */
+static constexpr bool table_action_valid(int act, int state)
+{
+    switch (act)
+    {
+    case action::collect:
+        return state == state::escape_intermediate
+                || state == state::csi_param
+                || state == state::csi_intermediate
+                || state == state::dcs_param
+                || state == state::dcs_intermediate;
+    case action::param:
+        return state == state::csi_param || state == state::dcs_param;
+    default:
+        return true;
+    }
+}
+
+/**
+ * Check that the table and events only call for actions in states that may
+ * carry them out. The action for a codepoint is carried out after its
+ * transition, if any. With this, no action can be illegal while decoding.
+ *
+ * @return True if such is the case, otherwise false
+ */
+static constexpr bool table_check_actions()
+{
+    for (std::size_t s = 0; s < table.size(); ++s)
+    {
+        for (std::size_t c = 0; c < 256; ++c)
+        {
+            auto pred = table[s][c];
+            auto after = pred.target > state::none ? pred.target : static_cast<int>(s);
+
+            if (pred.action > action::none && !table_action_valid(pred.action, after))
+            {
+                return false;
+            }
+        }
+
+        auto events = table_events[s];
+
+        if (!table_action_valid(events.leave.action, s) || !table_action_valid(events.enter.action, s))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static_assert(table_check_actions(), "table calls for an action in a state that cannot carry it out");
+
+/**
+ * A table predicate packed into a single octet. The action index occupies the
+ * low nibble and the target state index occupies the high nibble, each offset
+ * by one so that none is zero.
+ */
+using table_packed_predicate = std::uint8_t;
+
+static_assert(action::osc_end + 1 < 16, "action indices do not fit in a nibble");
+static_assert(state::sos_pm_apc_string + 1 < 16, "state indices do not fit in a nibble");
+
+/**
+ * Pack a table predicate.
+ *
+ * @param pred The predicate
+ * @return The packed predicate
+ */
+constexpr table_packed_predicate table_pack(table_predicate pred)
+{
+    return static_cast<table_packed_predicate>((pred.action + 1) | (pred.target + 1) << 4);
+}
+
+/**
+ * Unpack a table predicate.
+ *
+ * @param packed The packed predicate
+ * @return The predicate
+ */
+constexpr table_predicate table_unpack(table_packed_predicate packed)
+{
+    return table_predicate {(packed & 0xf) - 1, (packed >> 4) - 1};
+}
+
+/**
+ * Build the packed state transition table from the wide one.
+ *
+ * @return The packed table
+ */
+static constexpr auto table_build_packed()
+{
+    std::array<std::array<table_packed_predicate, 256>, table.size()> packed {};
+
+    for (std::size_t s = 0; s < table.size(); ++s)
+    {
+        for (std::size_t c = 0; c < 256; ++c)
+        {
+            packed[s][c] = table_pack(table[s][c]);
+        }
+    }
+
+    return packed;
+}
+
+/**
+ * The packed state transition table. Index by state, then by unsigned octet.
+ * At one octet per entry, it is an eighth the size of the wide table.
+ */
+static constexpr auto table_packed = table_build_packed();
+
+/**
+ * Check that the packed table says the same thing as the wide one.
+ *
+ * @return True if such is the case, otherwise false
+ */
+static constexpr bool table_check_packed()
+{
+    for (std::size_t s = 0; s < table.size(); ++s)
+    {
+        for (std::size_t c = 0; c < 256; ++c)
+        {
+            auto pred = table_unpack(table_packed[s][c]);
+
+            if (pred.action != table[s][c].action || pred.target != table[s][c].target)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static_assert(table_check_packed(), "packed table does not match wide table");
+
+/**
+ * Test whether two octets have identical columns in the packed table. Such
+ * octets are indistinguishable to the state machine.
+ *
+ * @param a The first octet
+ * @param b The second octet
+ * @return True if such is the case, otherwise false
+ */
+static constexpr bool table_columns_equal(std::size_t a, std::size_t b)
+{
+    for (std::size_t s = 0; s < table_packed.size(); ++s)
+    {
+        if (table_packed[s][a] != table_packed[s][b])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Build the map from octets to their equivalence classes. Octets are in the
+ * same class if and only if their table columns are identical.
+ *
+ * @return The class map
+ */
+static constexpr auto table_build_class_map()
+{
+    std::array<std::uint8_t, 256> map {};
+    std::uint8_t count = 0;
+
+    for (std::size_t c = 0; c < 256; ++c)
+    {
+        // Look for an earlier octet with an identical column
+        std::size_t d = 0;
+        while (d < c && !table_columns_equal(c, d))
+        {
+            ++d;
+        }
+
+        // Join its class if there is one, otherwise start a new class
+        map[c] = d < c ? map[d] : count++;
+    }
+
+    return map;
+}
+
+/**
+ * The map from octets to their equivalence classes.
+ */
+static constexpr auto table_class_map = table_build_class_map();
+
+/**
+ * Count the equivalence classes of octets.
+ *
+ * @return The class count
+ */
+static constexpr std::size_t table_count_classes()
+{
+    std::size_t count = 0;
+
+    for (auto cls : table_class_map)
+    {
+        if (cls >= count)
+        {
+            count = cls + 1;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * The number of equivalence classes of octets.
+ */
+static constexpr auto table_class_count = table_count_classes();
+
+/**
+ * Build the class-compressed state transition table from the packed one.
+ *
+ * @return The class-compressed table
+ */
+static constexpr auto table_build_classes()
+{
+    std::array<std::array<table_packed_predicate, table_class_count>, table_packed.size()> classes {};
+
+    for (std::size_t s = 0; s < table_packed.size(); ++s)
+    {
+        for (std::size_t c = 0; c < 256; ++c)
+        {
+            classes[s][table_class_map[c]] = table_packed[s][c];
+        }
+    }
+
+    return classes;
+}
+
+/**
+ * The class-compressed state transition table. Index by state, then by the
+ * class of an unsigned octet from table_class_map.
+ */
+static constexpr auto table_classes = table_build_classes();
+
+/**
+ * Check that the class-compressed table says the same thing as the packed one.
+ *
+ * @return True if such is the case, otherwise false
+ */
+static constexpr bool table_check_classes()
+{
+    for (std::size_t s = 0; s < table_packed.size(); ++s)
+    {
+        for (std::size_t c = 0; c < 256; ++c)
+        {
+            if (table_classes[s][table_class_map[c]] != table_packed[s][c])
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static_assert(table_check_classes(), "class-compressed table does not match packed table");
+
+/**
+ * A fused table entry. This is the complete, ordered list of micro-operations
+ * for putting an octet in a state: the leave action of the current state, the
+ * enter action of the target state, the action for the octet, and the target
+ * state itself. Each index is offset by one so that none is zero and packed
+ * into a nibble.
+ */
+struct table_fused_op
+{
+    /** The packed micro-operations. */
+    std::uint16_t bits;
+
+    /**
+     * @return The action for the octet
+     */
+    constexpr int action() const
+    { return (bits & 0xf) - 1; }
+
+    /**
+     * @return The target state, if a transition is to be made
+     */
+    constexpr int target() const
+    { return (bits >> 4 & 0xf) - 1; }
+
+    /**
+     * @return The leave action of the current state, if a transition is to be made
+     */
+    constexpr int leave() const
+    { return (bits >> 8 & 0xf) - 1; }
+
+    /**
+     * @return The enter action of the target state, if a transition is to be made
+     */
+    constexpr int enter() const
+    { return (bits >> 12 & 0xf) - 1; }
+};
+
+/**
+ * Fuse micro-operations into a table entry.
+ *
+ * @param action The action for the octet
+ * @param target The target state
+ * @param leave The leave action of the current state
+ * @param enter The enter action of the target state
+ * @return The fused entry
+ */
+constexpr table_fused_op table_fuse(int action, int target, int leave, int enter)
+{
+    return table_fused_op {static_cast<std::uint16_t>(
+            (action + 1) | (target + 1) << 4 | (leave + 1) << 8 | (enter + 1) << 12)};
+}
+
+/**
+ * Fuse the micro-operations for putting an octet in a state, as found in the
+ * wide table and the events.
+ *
+ * @param s The state index
+ * @param c The octet
+ * @return The fused entry
+ */
+static constexpr table_fused_op table_fuse_entry(std::size_t s, std::size_t c)
+{
+    auto pred = table[s][c];
+
+    // Leave and enter actions only happen on transition
+    int leave = action::none;
+    int enter = action::none;
+
+    if (pred.target > state::none)
+    {
+        leave = table_events[s].leave.action;
+        enter = table_events[pred.target].enter.action;
+    }
+
+    return table_fuse(pred.action, pred.target, leave, enter);
+}
+
+/**
+ * Count the distinct fused entries.
+ *
+ * @return The fused entry count
+ */
+static constexpr std::size_t table_count_fused_ops()
+{
+    std::array<std::uint16_t, table.size() * 256> seen {};
+    std::size_t count = 0;
+
+    for (std::size_t s = 0; s < table.size(); ++s)
+    {
+        for (std::size_t c = 0; c < 256; ++c)
+        {
+            auto op = table_fuse_entry(s, c);
+
+            std::size_t i = 0;
+            while (i < count && seen[i] != op.bits)
+            {
+                ++i;
+            }
+
+            if (i == count)
+            {
+                seen[count++] = op.bits;
+            }
+        }
+    }
+
+    return count;
+}
+
+/**
+ * The number of distinct fused entries.
+ */
+static constexpr auto table_fused_op_count = table_count_fused_ops();
+
+static_assert(table_fused_op_count <= 256, "fused entries do not fit an octet");
+
+/**
+ * Build the list of distinct fused entries, in order of first appearance.
+ *
+ * @return The fused entries
+ */
+static constexpr auto table_build_fused_ops()
+{
+    std::array<table_fused_op, table_fused_op_count> ops {};
+    std::size_t count = 0;
+
+    for (std::size_t s = 0; s < table.size(); ++s)
+    {
+        for (std::size_t c = 0; c < 256; ++c)
+        {
+            auto op = table_fuse_entry(s, c);
+
+            std::size_t i = 0;
+            while (i < count && ops[i].bits != op.bits)
+            {
+                ++i;
+            }
+
+            if (i == count)
+            {
+                ops[count++] = op;
+            }
+        }
+    }
+
+    return ops;
+}
+
+/**
+ * The distinct fused entries. Each is a whole program of micro-operations,
+ * and the fused table refers to them by index.
+ */
+static constexpr auto table_fused_ops = table_build_fused_ops();
+
+/**
+ * Build the fused state transition table from the wide one and the events.
+ *
+ * @return The fused table
+ */
+static constexpr auto table_build_fused()
+{
+    std::array<std::array<std::uint8_t, 256>, table.size()> fused {};
+
+    for (std::size_t s = 0; s < table.size(); ++s)
+    {
+        for (std::size_t c = 0; c < 256; ++c)
+        {
+            auto op = table_fuse_entry(s, c);
+
+            std::size_t i = 0;
+            while (table_fused_ops[i].bits != op.bits)
+            {
+                ++i;
+            }
+
+            fused[s][c] = static_cast<std::uint8_t>(i);
+        }
+    }
+
+    return fused;
+}
+
+/**
+ * The fused state transition table. Index by state, then by unsigned octet,
+ * to get an index into table_fused_ops.
+ */
+static constexpr auto table_fused = table_build_fused();
+
+/**
+ * Check that the fused table says the same thing as the wide one and the
+ * events together.
+ *
+ * @return True if such is the case, otherwise false
+ */
+static constexpr bool table_check_fused()
+{
+    for (std::size_t s = 0; s < table.size(); ++s)
+    {
+        for (std::size_t c = 0; c < 256; ++c)
+        {
+            auto op = table_fused_ops[table_fused[s][c]];
+            auto pred = table[s][c];
+
+            if (op.action() != pred.action || op.target() != pred.target)
+            {
+                return false;
+            }
+
+            auto transition = pred.target > state::none;
+
+            if (op.leave() != (transition ? table_events[s].leave.action : action::none))
+            {
+                return false;
+            }
+
+            if (op.enter() != (transition ? table_events[pred.target].enter.action : action::none))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static_assert(table_check_fused(), "fused table does not match wide table");
+
+/**
+ * Table backend: the wide table. This is the reference.
+ */
+struct table_backend_wide
+{
+    /**
+     * Look up the predicate for an octet in a state.
+     *
+     * @param state The state index
+     * @param c The octet
+     * @return The predicate
+     */
+    static constexpr table_predicate lookup(int state, unsigned char c)
+    { return table[state][c]; }
+};
+
+/**
+ * Table backend: the packed table. One lookup into 3.5 KB.
+ */
+struct table_backend_packed
+{
+    /**
+     * Look up the predicate for an octet in a state.
+     *
+     * @param state The state index
+     * @param c The octet
+     * @return The predicate
+     */
+    static constexpr table_predicate lookup(int state, unsigned char c)
+    { return table_unpack(table_packed[state][c]); }
+};
+
+/**
+ * Table backend: the class-compressed table. Two lookups into well under 1 KB.
+ */
+struct table_backend_classes
+{
+    /**
+     * Look up the predicate for an octet in a state.
+     *
+     * @param state The state index
+     * @param c The octet
+     * @return The predicate
+     */
+    static constexpr table_predicate lookup(int state, unsigned char c)
+    { return table_unpack(table_classes[state][table_class_map[c]]); }
+};
+
+/**
+ * Table backend: the fused table. One lookup into 3.5 KB names the whole
+ * program of micro-operations for an octet, so that the decoder can dispatch
+ * on it once.
+ */
+struct table_backend_fused
+{
+    /**
+     * Look up the fused micro-operations for an octet in a state.
+     *
+     * @param state The state index
+     * @param c The octet
+     * @return The index of the fused entry in table_fused_ops
+     */
+    static constexpr int lookup(int state, unsigned char c)
+    { return table_fused[state][c]; }
+};
+
 } // namespace vtdec
 
 #endif // #ifndef VTDEC_TABLE_H
@@ -0,0 +1,126 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Checks that every optimized way of decoding gives the same events as the
+ * reference state machine, on hand-picked sequences and on random input.
+ */
+
+#include <cstdint>
+#include <string>
+
+#include "differential.h"
+#include "harness.h"
+
+using namespace vtdec::test;
+
+namespace
+{
+
+/**
+ * Check one input under a few seeds.
+ */
+void check_input(const std::string& input, std::uint32_t seeds = 8)
+{
+    for (std::uint32_t seed = 1; seed <= seeds; ++seed)
+    {
+        auto diff = differ(input, seed);
+
+        if (!check(diff.empty(), diff))
+        {
+            return;
+        }
+    }
+}
+
+/**
+ * Generate random input, biased toward octets that matter to the decoder.
+ */
+std::string random_input(xorshift& rng)
+{
+    static constexpr char alphabet[] = "\x1b[]P;:0123456789?>m q#!$-\\\x07\x18\x1a\x7f\r\n"
+                                       "\x90\x9b\x9c\x9d\xc3\xa9\xe4\xb8\xad\xf0\x9f";
+
+    std::string out;
+    auto n = rng() % 96;
+
+    for (std::uint32_t i = 0; i < n; ++i)
+    {
+        if (rng() % 4 == 0)
+        {
+            out += static_cast<char>(rng());
+        }
+        else
+        {
+            out += alphabet[rng() % (sizeof(alphabet) - 1)];
+        }
+    }
+
+    return out;
+}
+
+registrar r1 {"differential/sequences", [] {
+    static const char* inputs[] = {
+            "plain text\r\n",
+            "\x1b[1;31mred\x1b[0m \x1b[38;5;208morange\x1b[m",
+            "\x1b[38:2::255:128:0mtrue color\x1b[0m",
+            "\x1b[?1049h\x1b[H\x1b[2J\x1b[12;40H\x1b[K\x1b[?25l",
+            "\x1b[>0;1;2;3;4;5;6;7;8;9;10;11;12;13;14;15;16;17;18;19;20;21;22;23;24;25;26;27;28;29;30;31;32;33c",
+            "\x1b[99999999999m\x1b[1;2;3$p\x1b[1 q",
+            "\x1b]0;title\x07more\x1b\\after",
+            "\x1b]52;c;aGVsbG8gd29ybGQ=\x1b\\",
+            "\x9d" "8;;https://example.com\x9c" "href\x9d" "8;;\x9c",
+            "\x1bP0;1;0q\"1;1;8;8#0;2;0;0;0#0!8~-\r\n#1~~~~\x1b\\",
+            "\x1bP1$r0m\x1b\\\x90+q544e\x9c",
+            "\x1bX sos \x1b\\\x1b^ pm \x1b\\\x1b_ apc \x9c",
+            "\x1b[1;2\x18" "abc\x1b]0;x\x1a\x1bP1q\x1b[A",
+            "caf\xc3\xa9 \xe4\xb8\xad\xe6\x96\x87 \xf0\x9f\x98\x80 \xc0\xaf \xed\xa0\x80 \xe4\xb8",
+            "\x1b(B\x1b)0\x1b#8\x1b" "7\x1b" "8\x1b" "c",
+    };
+
+    for (auto input : inputs)
+    {
+        check_input(input, 64);
+    }
+}};
+
+registrar r2 {"differential/random", [] {
+    xorshift rng {12345};
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        auto input = random_input(rng);
+        auto diff = differ(input, rng());
+
+        if (!check(diff.empty(), diff))
+        {
+            return;
+        }
+    }
+}};
+
+} // namespace
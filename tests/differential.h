@@ -0,0 +1,429 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+#ifndef VTDEC_TEST_DIFFERENTIAL_H
+#define VTDEC_TEST_DIFFERENTIAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <vtdec/decode.h>
+#include <vtdec/decoder.h>
+
+namespace vtdec::test
+{
+
+/**
+ * A processor that writes down everything it sees. Runs are written down as
+ * the codepoints they hold, so the record does not depend on whether the
+ * decoder took a fast path. The decode_begin and decode_end hooks are left
+ * out, as they come once per call.
+ *
+ * @tparam Backend The table backend
+ * @tparam Trace Whether to take the tracing hooks
+ */
+template<class Backend, bool Trace>
+struct recorder : static_processor<recorder<Backend, Trace>>
+{
+    using table_backend = Backend;
+
+    static constexpr bool wants_trace = Trace;
+
+    /** The events other than tracing, one per line. */
+    std::string events;
+
+    /** All events, including tracing, one per line. */
+    std::string full;
+
+    void add(const char* name, std::uint32_t arg)
+    {
+        auto line = std::string {name} + ' ' + std::to_string(arg) + '\n';
+        events += line;
+        full += line;
+    }
+
+    void add_sequence(const char* name, const csi_sequence& seq, char final)
+    {
+        auto line = std::string {name} + ' ' + final + " m=" + std::to_string(seq.private_marker)
+                + " o=" + std::to_string(seq.overflow) + " s=" + std::to_string(seq.subparams) + " p=";
+
+        for (std::size_t i = 0; i < seq.param_count; ++i)
+        {
+            line += std::to_string(seq.params[i]) + ',';
+        }
+
+        line += " i=" + std::string(seq.intermediates, seq.intermediate_count) + '\n';
+        events += line;
+        full += line;
+    }
+
+    void trace(const char* name, int a, int b = 0)
+    { full += std::string {name} + ' ' + std::to_string(a) + ' ' + std::to_string(b) + '\n'; }
+
+    void print(char32_t c)
+    { add("print", c); }
+
+    void print_run(std::string_view str)
+    {
+        for (auto c : str)
+        {
+            add("print", static_cast<unsigned char>(c));
+        }
+    }
+
+    void print_run(std::u32string_view str)
+    {
+        for (auto c : str)
+        {
+            add("print", c);
+        }
+    }
+
+    void ctl(char c)
+    { add("ctl", static_cast<unsigned char>(c)); }
+
+    void ctl_begin()
+    { add("ctl_begin", 0); }
+
+    void ctl_put(char32_t c)
+    { add("ctl_put", c); }
+
+    void csi_dispatch(const csi_sequence& seq, char final)
+    { add_sequence("csi_dispatch", seq, final); }
+
+    void ctl_end(bool cancel)
+    { add("ctl_end", cancel); }
+
+    void dcs_begin()
+    { add("dcs_begin", 0); }
+
+    void dcs_hook(const csi_sequence& seq, char final)
+    { add_sequence("dcs_hook", seq, final); }
+
+    void dcs_put(char32_t c)
+    { add("dcs_put", c); }
+
+    void dcs_data(std::string_view str)
+    {
+        for (auto c : str)
+        {
+            add("dcs_put", static_cast<unsigned char>(c));
+        }
+    }
+
+    void dcs_end(bool cancel)
+    { add("dcs_end", cancel); }
+
+    void osc_begin()
+    { add("osc_begin", 0); }
+
+    void osc_put(char32_t c)
+    { add("osc_put", c); }
+
+    void osc_data(std::string_view str)
+    {
+        for (auto c : str)
+        {
+            add("osc_put", static_cast<unsigned char>(c));
+        }
+    }
+
+    void osc_end(bool cancel)
+    { add("osc_end", cancel); }
+
+    void decode_put(char32_t c)
+    { trace("put", c); }
+
+    void decode_action(int act)
+    { trace("action", act); }
+
+    void decode_transition(int src, int dst)
+    { trace("transition", src, dst); }
+};
+
+/**
+ * The reference: the wide table, one codepoint at a time, with tracing.
+ */
+using reference = recorder<table_backend_wide, true>;
+
+/**
+ * A small, fast pseudorandom generator, so results do not depend on the
+ * standard library.
+ */
+struct xorshift
+{
+    std::uint32_t state;
+
+    std::uint32_t operator()()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+};
+
+/**
+ * Call a function on successive chunks of a string, split at random. Some
+ * chunks are empty.
+ */
+template<class Function>
+void for_each_chunk(std::string_view str, std::uint32_t seed, Function&& f)
+{
+    xorshift rng {seed | 1};
+
+    while (!str.empty())
+    {
+        auto n = rng() % 4 == 0 ? rng() % 64 : rng() % 5;
+        auto chunk = str.substr(0, n);
+        f(chunk);
+        str.remove_prefix(chunk.size());
+    }
+}
+
+/**
+ * Generate random input, mostly octets that start, carry, or end sequences,
+ * with UTF-8 and arbitrary octets mixed in.
+ *
+ * @param rng The generator
+ * @param size The size of the input
+ * @return The input
+ */
+inline std::string random_terminal_input(xorshift& rng, std::size_t size)
+{
+    static constexpr char alphabet[] = "\x1b[]P;0123456789mq\x07\x18\x90\x9b\x9c\x9d\xc3\xa9\xe4\xb8\xad";
+
+    std::string out(size, ' ');
+
+    for (auto& c : out)
+    {
+        c = static_cast<char>(rng() % 3 ? alphabet[rng() % (sizeof(alphabet) - 1)] : rng());
+    }
+
+    return out;
+}
+
+/**
+ * A processor that counts decode operations.
+ */
+struct counter : static_processor<counter>
+{
+    int begins {};
+    int ends {};
+
+    void decode_begin()
+    { ++begins; }
+
+    void decode_end(bool cancel)
+    { ++ends; }
+};
+
+/**
+ * Limits for differential runs, small enough to be hit.
+ */
+struct small_limits
+{
+    std::size_t max_csi;
+    std::size_t max_dcs;
+    std::size_t max_osc;
+};
+
+/**
+ * Internal. Compare one record against another, describing the first
+ * difference, if any.
+ */
+inline std::string compare(const char* what, const std::string& expected, const std::string& actual)
+{
+    if (expected == actual)
+    {
+        return {};
+    }
+
+    std::size_t i = 0;
+    while (i < expected.size() && i < actual.size() && expected[i] == actual[i])
+    {
+        ++i;
+    }
+
+    auto line = expected.rfind('\n', i);
+    line = line == std::string::npos ? 0 : line + 1;
+
+    return std::string {what} + ": expected \"" + expected.substr(line, 40) + "\" but got \""
+            + actual.substr(line, 40) + '"';
+}
+
+/**
+ * Decode an input every way there is and compare against the reference.
+ *
+ * Every table backend must give the reference's full trace. Every fast path,
+ * every overload, and every split of the input into chunks must give the
+ * reference's events. The seed picks the chunk splits and the limits.
+ *
+ * @param input The input
+ * @param seed The seed
+ * @return A description of the first difference, or empty if none
+ */
+inline std::string differ(std::string_view input, std::uint32_t seed)
+{
+    std::string diff;
+
+    auto fail = [&diff](std::string d) {
+        if (diff.empty())
+        {
+            diff = std::move(d);
+        }
+    };
+
+    // Octets, one at a time through the wide table
+    reference ref;
+    decode(input, ref);
+
+    {
+        recorder<table_backend_packed, true> packed;
+        recorder<table_backend_classes, true> classes;
+        recorder<table_backend_fused, true> fused;
+        decode(input, packed);
+        decode(input, classes);
+        decode(input, fused);
+        fail(compare("packed traced", ref.full, packed.full));
+        fail(compare("classes traced", ref.full, classes.full));
+        fail(compare("fused traced", ref.full, fused.full));
+    }
+
+    {
+        recorder<table_backend_wide, false> wide;
+        recorder<table_backend_packed, false> packed;
+        recorder<table_backend_classes, false> classes;
+        recorder<table_backend_fused, false> fused;
+        decode(input, wide);
+        decode(input, packed);
+        decode(input, classes);
+        decode(input, fused);
+        fail(compare("wide", ref.events, wide.events));
+        fail(compare("packed", ref.events, packed.events));
+        fail(compare("classes", ref.events, classes.events));
+        fail(compare("fused", ref.events, fused.events));
+    }
+
+    {
+        recorder<table_backend_fused, false> iter;
+        decode(input.begin(), input.end(), iter);
+        fail(compare("iterator", ref.events, iter.events));
+    }
+
+    {
+        recorder<table_backend_fused, false> fast;
+        recorder<table_backend_fused, true> traced;
+        decode_state fast_state {};
+        decode_state traced_state {};
+        for_each_chunk(input, seed, [&](std::string_view chunk) {
+            fast_state = decode(chunk, fast, fast_state);
+            traced_state = decode(chunk, traced, traced_state);
+        });
+        fail(compare("fused chunked", ref.events, fast.events));
+        fail(compare("fused traced chunked", ref.full, traced.full));
+    }
+
+    // 32-bit codepoints below 0xa0 mean the same as octets
+    {
+        std::u32string wide;
+        auto narrow = true;
+
+        for (auto c : input)
+        {
+            wide += static_cast<unsigned char>(c);
+            narrow = narrow && static_cast<unsigned char>(c) < 0xa0;
+        }
+
+        if (narrow)
+        {
+            recorder<table_backend_fused, false> fast;
+            recorder<table_backend_fused, true> traced;
+            decode(std::u32string_view {wide}, fast);
+            decode(std::u32string_view {wide}, traced);
+            fail(compare("u32", ref.events, fast.events));
+            fail(compare("u32 traced", ref.full, traced.full));
+        }
+    }
+
+    // UTF-8
+    {
+        reference ref8;
+        auto ref8_state = decode_utf8(input, ref8);
+
+        recorder<table_backend_fused, false> fast;
+        decode_utf8(input, fast);
+        fail(compare("utf8", ref8.events, fast.events));
+
+        recorder<table_backend_fused, false> chunked;
+        recorder<table_backend_fused, true> traced;
+        recorder<table_backend_fused, false> bound;
+        decode_state chunked_state {};
+        decode_state traced_state {};
+        decoder<recorder<table_backend_fused, false>> dec {bound};
+        for_each_chunk(input, seed * 31, [&](std::string_view chunk) {
+            chunked_state = decode_utf8(chunk, chunked, chunked_state);
+            traced_state = decode_utf8(chunk, traced, traced_state);
+            dec.feed(chunk);
+        });
+        fail(compare("utf8 chunked", ref8.events, chunked.events));
+        fail(compare("utf8 traced chunked", ref8.full, traced.full));
+
+        // The end of the stream, too
+        dec.flush();
+        flush(ref8, ref8_state);
+        fail(compare("decoder", ref8.events, bound.events));
+    }
+
+    // Limits
+    {
+        xorshift rng {seed * 17 | 1};
+        small_limits limits {rng() % 16, rng() % 24, rng() % 24};
+
+        reference refl;
+        decode(input, refl, {}, limits);
+
+        recorder<table_backend_fused, false> fast;
+        decode(input, fast, {}, limits);
+        fail(compare("limits", refl.events, fast.events));
+
+        recorder<table_backend_fused, false> chunked;
+        decode_state state {};
+        for_each_chunk(input, seed * 7, [&](std::string_view chunk) {
+            state = decode(chunk, chunked, state, limits);
+        });
+        fail(compare("limits chunked", refl.events, chunked.events));
+    }
+
+    return diff;
+}
+
+} // namespace vtdec::test
+
+#endif // #ifndef VTDEC_TEST_DIFFERENTIAL_H
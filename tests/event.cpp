@@ -0,0 +1,136 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Checks that decoding to event records and replaying them gives the same
+ * events as decoding straight to a processor, with arenas of any size.
+ */
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <vtdec/event.h>
+
+#include "differential.h"
+#include "harness.h"
+
+using namespace vtdec::test;
+
+namespace
+{
+
+/**
+ * Decode to events through a small arena, replaying and clearing it whenever
+ * it might fill up.
+ */
+template<bool Utf8>
+std::string decode_through(std::string_view input, std::size_t events, std::size_t sequences)
+{
+    // Spare room past the capacity catches overflow
+    std::vector<vtdec::event> event_store(events + 64);
+    std::vector<vtdec::csi_sequence> sequence_store(sequences + 8);
+
+    vtdec::event_arena arena {event_store.data(), events, 0, sequence_store.data(), sequences, 0};
+    vtdec::decode_state state {};
+    recorder<vtdec::table_backend_fused, false> proc;
+
+    while (!input.empty())
+    {
+        auto n = Utf8
+                ? vtdec::decode_utf8_events(input, arena, state)
+                : vtdec::decode_events(input, arena, state);
+
+        if (!check(arena.event_count <= arena.event_capacity, "event overflow")
+                || !check(arena.sequence_count <= arena.sequence_capacity, "sequence overflow")
+                || !check(n != 0 || arena.event_count != 0, "no progress"))
+        {
+            break;
+        }
+
+        vtdec::replay(arena, proc);
+        arena.clear();
+        input.remove_prefix(n);
+    }
+
+    return proc.events;
+}
+
+registrar r1 {"event/replay", [] {
+    xorshift rng {4242};
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        auto input = random_terminal_input(rng, rng() % 200);
+
+        reference ref;
+        vtdec::decode(std::string_view {input}, ref);
+
+        reference ref8;
+        vtdec::decode_utf8(std::string_view {input}, ref8);
+
+        auto events = 10 + rng() % 100;
+        auto sequences = 1 + rng() % 4;
+
+        if (!check(decode_through<false>(input, events, sequences) == ref.events, "octets")
+                || !check(decode_through<true>(input, events, sequences) == ref8.events, "utf8"))
+        {
+            return;
+        }
+    }
+}};
+
+registrar r2 {"event/records", [] {
+    std::vector<vtdec::event> events(64);
+    std::vector<vtdec::csi_sequence> sequences(4);
+
+    vtdec::event_arena arena {events.data(), events.size(), 0, sequences.data(), sequences.size(), 0};
+    vtdec::decode_state state {};
+
+    std::string_view input = "ab\x1b[1;2mcd\x1b]0;t\x1b\\";
+    check(vtdec::decode_events(input, arena, state) == input.size(), "whole input fits");
+
+    // Runs of text are spans of the input
+    check(events[0].kind == vtdec::event_kind::print_run && events[0].run() == "ab", "print run");
+    check(events[0].data == input.data(), "print run points into input");
+
+    // The parsed sequence is stored aside
+    auto csi = events[0];
+    for (std::size_t i = 0; i < arena.event_count; ++i)
+    {
+        if (events[i].kind == vtdec::event_kind::csi_dispatch)
+        {
+            csi = events[i];
+        }
+    }
+
+    check(csi.kind == vtdec::event_kind::csi_dispatch && csi.flag == 'm', "csi dispatch");
+    check(sequences[csi.value].param(0) == 1 && sequences[csi.value].param(1) == 2, "csi params");
+}};
+
+} // namespace
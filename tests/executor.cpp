@@ -0,0 +1,184 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Checks that sessions decoded across threads decode the same as each would
+ * on its own, and that the workers account for all of the work.
+ */
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <vtdec/decoder.h>
+#include <vtdec/executor.h>
+
+#include "differential.h"
+#include "harness.h"
+
+using namespace vtdec::test;
+
+namespace
+{
+
+using processor = recorder<vtdec::table_backend_fused, false>;
+
+/**
+ * A processor that throws on a BEL.
+ */
+struct thrower : vtdec::static_processor<thrower>
+{
+    int prints {};
+
+    void print(char32_t c)
+    { ++prints; }
+
+    void ctl(char c)
+    {
+        if (c == '\a')
+        {
+            throw std::runtime_error {"bell"};
+        }
+    }
+};
+
+void run(std::size_t workers)
+{
+    constexpr std::size_t sessions = 100;
+
+    xorshift rng {static_cast<std::uint32_t>(9001 + workers)};
+
+    // Session 0 is heavy, as if running cat on a big log, and the rest are light
+    std::vector<std::string> inputs(sessions);
+    std::vector<std::string_view> rest(sessions);
+    std::size_t total = 0;
+
+    for (std::size_t i = 0; i < sessions; ++i)
+    {
+        inputs[i] = random_terminal_input(rng, i == 0 ? 1 << 16 : rng() % 256);
+
+        rest[i] = inputs[i];
+        total += inputs[i].size();
+    }
+
+    vtdec::session_pool<processor> pool;
+    vtdec::session_executor exec {workers};
+
+    for (std::size_t i = 0; i < sessions; ++i)
+    {
+        pool.open();
+    }
+
+    std::size_t fed = 0;
+    std::size_t pieces = 0;
+
+    while (fed < total)
+    {
+        std::vector<vtdec::session_input> batch;
+
+        for (int j = 0; j < 256; ++j)
+        {
+            auto i = rng() % 8 == 0 ? 0 : rng() % sessions;
+            auto piece = rest[i].substr(0, i == 0 ? rng() % 2048 : rng() % 24);
+            batch.push_back({i, piece});
+            rest[i].remove_prefix(piece.size());
+            fed += piece.size();
+        }
+
+        pieces += batch.size();
+        exec.feed(pool, batch.begin(), batch.end());
+    }
+
+    std::size_t stat_pieces = 0;
+    std::size_t stat_bytes = 0;
+
+    for (std::size_t w = 0; w < exec.size(); ++w)
+    {
+        stat_pieces += exec.stats(w).pieces;
+        stat_bytes += exec.stats(w).bytes;
+    }
+
+    check(exec.size() == workers, "worker count");
+    check(stat_pieces == pieces, "stats count every piece");
+    check(stat_bytes == total, "stats count every octet");
+
+    for (std::size_t i = 0; i < sessions; ++i)
+    {
+        pool.flush(i);
+
+        processor whole;
+        vtdec::decoder<processor> dec {whole};
+        dec.feed(inputs[i]);
+        dec.flush();
+
+        auto diff = compare("session", whole.events, pool.target(i).events);
+
+        if (!check(diff.empty(), diff.c_str()))
+        {
+            return;
+        }
+    }
+}
+
+registrar r1 {"executor/one", [] { run(1); }};
+registrar r2 {"executor/many", [] { run(4); }};
+
+registrar r3 {"executor/exception", [] {
+    vtdec::session_pool<thrower> pool;
+    vtdec::session_executor exec {3};
+
+    for (int i = 0; i < 8; ++i)
+    {
+        pool.open();
+    }
+
+    vtdec::session_input batch[] {{0, "ab"}, {1, "cd\a"}, {1, "ef"}, {2, "gh"}, {5, "ij"}};
+    auto thrown = false;
+
+    try
+    {
+        exec.feed(pool, std::begin(batch), std::end(batch));
+    }
+    catch (const std::runtime_error&)
+    {
+        thrown = true;
+    }
+
+    check(thrown, "exception passed to the caller");
+    check(pool.target(1).prints == 2, "rest of the throwing session dropped");
+    check(pool.target(0).prints == 2 && pool.target(2).prints == 2 && pool.target(5).prints == 2,
+            "other sessions carry on");
+
+    // The executor is still usable afterward
+    vtdec::session_input again[] {{1, "kl"}};
+    exec.feed(pool, std::begin(again), std::end(again));
+    check(pool.target(1).prints == 4, "usable after an exception");
+}};
+
+} // namespace
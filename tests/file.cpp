@@ -0,0 +1,152 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Checks that decoding a file a window at a time gives the same callbacks as
+ * decoding it in one piece.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <system_error>
+
+#include <unistd.h>
+
+#include <vtdec/decoder.h>
+#include <vtdec/file.h>
+
+#include "differential.h"
+#include "harness.h"
+
+using namespace vtdec::test;
+
+namespace
+{
+
+/**
+ * A temporary file, removed on destruction.
+ */
+struct temp_file
+{
+    std::string path;
+
+    explicit temp_file(const std::string& content)
+    {
+        char name[] = "/tmp/vtdec_test_XXXXXX";
+        auto fd = ::mkstemp(name);
+        path = name;
+
+        if (fd >= 0)
+        {
+            check(::write(fd, content.data(), content.size()) == static_cast<ssize_t>(content.size()), "write temp file");
+            ::close(fd);
+        }
+    }
+
+    ~temp_file()
+    { std::remove(path.c_str()); }
+};
+
+registrar r1 {"file/windows", [] {
+    using processor = recorder<vtdec::table_backend_fused, false>;
+
+    xorshift rng {8080};
+
+    for (int round = 0; round < 4; ++round)
+    {
+        // Long enough to cross many small windows, with sequences cut at every edge
+        auto input = random_terminal_input(rng, 100000 + rng() % 5000);
+
+        temp_file file {input};
+
+        processor mapped;
+        auto result = vtdec::decode_file(file.path.c_str(), mapped, vtdec::decode_config {}, 1);
+
+        check(!result.error, "no error");
+        check(result.bytes == input.size(), "every byte decoded");
+
+        processor whole;
+        vtdec::decoder<processor> dec {whole};
+        dec.feed(input);
+        dec.flush();
+
+        auto diff = compare("file", whole.events, mapped.events);
+
+        if (!check(diff.empty(), diff.c_str()))
+        {
+            return;
+        }
+    }
+}};
+
+registrar r2 {"file/aligned_windows", [] {
+    using processor = recorder<vtdec::table_backend_fused, false>;
+
+    xorshift rng {2097152};
+
+    // Windows of 2 MiB are mapped over an aligned reservation, each in place of the last
+    // The last one is short, so what is left of the one before must not be read
+    auto input = random_terminal_input(rng, (std::size_t {5} << 20) + 12345);
+
+    temp_file file {input};
+
+    processor mapped;
+    auto result = vtdec::decode_file(file.path.c_str(), mapped, vtdec::decode_config {}, std::size_t {1} << 21);
+
+    check(!result.error, "no error");
+    check(result.bytes == input.size(), "every byte decoded");
+
+    processor whole;
+    vtdec::decoder<processor> dec {whole};
+    dec.feed(input);
+    dec.flush();
+
+    auto diff = compare("file", whole.events, mapped.events);
+    check(diff.empty(), diff.c_str());
+}};
+
+registrar r3 {"file/errors", [] {
+    counter missing;
+    auto result = vtdec::decode_file("/nonexistent/vtdec", missing);
+    check(result.error == std::errc::no_such_file_or_directory, "missing file");
+    check(missing.begins == 0, "processor untouched");
+
+    counter directory;
+    result = vtdec::decode_file("/tmp", directory);
+    check(result.error == std::errc::invalid_argument, "not a regular file");
+
+    temp_file empty {""};
+    counter nothing;
+    result = vtdec::decode_file(empty.path.c_str(), nothing);
+    check(!result.error && result.bytes == 0, "empty file");
+    check(nothing.begins == 1 && nothing.ends == 1, "one decode operation");
+}};
+
+} // namespace
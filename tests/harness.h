@@ -0,0 +1,105 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+#ifndef VTDEC_TEST_HARNESS_H
+#define VTDEC_TEST_HARNESS_H
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vtdec::test
+{
+
+/**
+ * A test case.
+ */
+struct test_case
+{
+    /** The case name. */
+    std::string name;
+
+    /** Run the case. Failures are reported through check. */
+    std::function<void()> run;
+};
+
+/**
+ * The registry of all test cases.
+ *
+ * @return The registry
+ */
+inline std::vector<test_case>& registry()
+{
+    static std::vector<test_case> cases;
+    return cases;
+}
+
+/**
+ * Registers a test case on static initialization.
+ */
+struct registrar
+{
+    registrar(std::string p_name, std::function<void()> p_run)
+    {
+        registry().push_back({std::move(p_name), std::move(p_run)});
+    }
+};
+
+/**
+ * The number of failed checks so far.
+ *
+ * @return The count
+ */
+inline int& failures()
+{
+    static int count;
+    return count;
+}
+
+/**
+ * Check a condition, reporting a failure if it does not hold.
+ *
+ * @param ok The condition
+ * @param what A description of the failure
+ * @return The condition
+ */
+inline bool check(bool ok, const std::string& what)
+{
+    if (!ok)
+    {
+        ++failures();
+        std::fprintf(stderr, "    failed: %s\n", what.c_str());
+    }
+
+    return ok;
+}
+
+} // namespace vtdec::test
+
+#endif // #ifndef VTDEC_TEST_HARNESS_H
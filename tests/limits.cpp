@@ -0,0 +1,136 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Checks that sequences over their limits are cut off and their remainders
+ * ignored, case by case.
+ */
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include <vtdec/decode.h>
+
+#include "harness.h"
+
+using namespace vtdec::test;
+
+namespace
+{
+
+/**
+ * A processor that writes down what it sees. Sequences are bracketed, and a
+ * cancelled one ends with an exclamation mark.
+ */
+struct log : vtdec::static_processor<log>
+{
+    std::string out;
+
+    void print(char32_t c)
+    { out += static_cast<char>(c); }
+
+    void ctl_begin()
+    { out += "C{"; }
+
+    void ctl_put(char32_t c)
+    { out += static_cast<char>(c); }
+
+    void ctl_end(bool cancel)
+    { out += cancel ? "!" : "}"; }
+
+    void dcs_begin()
+    { out += "D{"; }
+
+    void dcs_put(char32_t c)
+    { out += static_cast<char>(c); }
+
+    void dcs_end(bool cancel)
+    { out += cancel ? "!" : "}"; }
+
+    void osc_begin()
+    { out += "O{"; }
+
+    void osc_put(char32_t c)
+    { out += static_cast<char>(c); }
+
+    void osc_end(bool cancel)
+    { out += cancel ? "!" : "}"; }
+};
+
+/**
+ * A case: an input and what is seen of it with every limit at four.
+ */
+struct limits_case
+{
+    std::string_view input;
+    const char* expected;
+};
+
+const limits_case cases[] = {
+        // Control sequences
+        {"a\x1b[1;2mb", "aC{1;2}b"},
+        {"a\x1b[1;23mb", "aC{1;23}b"},
+        {"a\x1b[1;234mb", "aC{1;23!b"},
+        {"a\x1b[1;234;5;6mb", "aC{1;23!b"},
+
+        // Device control strings, header and data together, ended by an escape sequence
+        {"a\x1bP1|xy\x1b\\b", "aD{1|xy}}b"},
+        {"a\x1bP1|xyz\x1b\\b", "aD{1|xy!}b"},
+        {"a\x1bP1|xyzzy\x1b\\b", "aD{1|xy!}b"},
+
+        // Operating system commands, where BEL is ignored
+        {"a\x1b]0;ab\x1b\\b", "aO{0;ab}}b"},
+        {"a\x1b]0;abc\x1b\\b", "aO{0;ab!}b"},
+        {"a\x1b]0;ab\x07" "c\x1b\\b", "aO{0;ab!}b"},
+        {"a\x1b]0;abcdef\x1b\\b", "aO{0;ab!}b"},
+
+        // The next sequence is not held to what the last one used
+        {"\x1b[1;234m\x1b[1;2m", "C{1;23!C{1;2}"},
+        {"\x1b]abcde\x1b\\\x1b]abcd\x1b\\", "O{abcd!}O{abcd}}"},
+};
+
+registrar r1 {"limits/cases", [] {
+    vtdec::decode_config cfg;
+    cfg.max_csi = 4;
+    cfg.max_dcs = 4;
+    cfg.max_osc = 4;
+
+    for (auto&& c : cases)
+    {
+        // Octet by octet through the table, then with the fast paths
+        log slow;
+        vtdec::decode(c.input.begin(), c.input.end(), slow, {}, cfg);
+        check(slow.out == c.expected, std::string {c.expected} + " but got " + slow.out + " octet by octet");
+
+        log fast;
+        vtdec::decode(c.input, fast, {}, cfg);
+        check(fast.out == c.expected, std::string {c.expected} + " but got " + fast.out);
+    }
+}};
+
+} // namespace
@@ -0,0 +1,63 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+#include <cstdio>
+#include <string>
+
+#include "harness.h"
+
+using namespace vtdec::test;
+
+int main(int argc, char* argv[])
+{
+    // Optional substring filter on case names
+    const char* filter = argc > 1 ? argv[1] : "";
+
+    int failed_cases = 0;
+
+    for (auto&& tc : registry())
+    {
+        if (tc.name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        std::printf("%s\n", tc.name.c_str());
+        std::fflush(stdout);
+
+        auto before = failures();
+        tc.run();
+
+        if (failures() != before)
+        {
+            ++failed_cases;
+        }
+    }
+
+    std::printf("%d case(s) failed\n", failed_cases);
+    return failed_cases ? 1 : 0;
+}
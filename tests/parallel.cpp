@@ -0,0 +1,193 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Checks that decoding one stream on many threads gives the same callbacks as
+ * decoding it serially, whether or not the speculation pays off.
+ */
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <vtdec/parallel.h>
+
+#include "differential.h"
+#include "harness.h"
+
+using namespace vtdec::test;
+
+namespace
+{
+
+/**
+ * Generate a long random stream: mostly text and complete sequences, with
+ * long strings, dense runs of sequences, and garbage mixed in, so that some
+ * cuts land mid-sequence and some arenas fill up.
+ */
+std::string random_stream(xorshift& rng, std::size_t size)
+{
+    static const char* pieces[] = {
+            "plain text ",
+            "\r\n",
+            "\xe4\xb8\xad\xe6\x96\x87 ",
+            "\x1b[1;31m",
+            "\x1b[0m",
+            "\x1b[38;5;208m",
+            "\x1b[12;40H\x1b[K",
+            "\x1b]0;title\x07",
+            "\x1b]52;c;aGVsbG8gd29ybGQ=\x1b\\",
+            "\x1bPq#0;2;0;0;0#1;2;100;100;0#1~~@@vv@@~~@@~~$-\x1b\\",
+            "\x1b[m\x1b[m\x1b[m\x1b[m\x1b[m\x1b[m\x1b[m\x1b[m",
+            "\x1b",
+            "\x1b[",
+            "\x1b]",
+            "\x90",
+            "\xc3",
+    };
+
+    std::string out;
+
+    while (out.size() < size)
+    {
+        switch (rng() % 8)
+        {
+        case 0:
+            // A long string, likely to cross a cut
+            out += "\x1b]2;";
+            out.append(rng() % 600, 'x');
+            out += "\x07";
+            break;
+        case 1:
+            out += static_cast<char>(rng());
+            break;
+        default:
+            out += pieces[rng() % (sizeof(pieces) / sizeof(*pieces))];
+            break;
+        }
+    }
+
+    return out;
+}
+
+template<bool Utf8>
+void check_stream(const std::string& input, vtdec::session_executor& exec, std::size_t chunk)
+{
+    recorder<vtdec::table_backend_fused, false> serial;
+    recorder<vtdec::table_backend_fused, false> parallel;
+
+    auto serial_state = Utf8
+            ? vtdec::decode_utf8(std::string_view {input}, serial)
+            : vtdec::decode(std::string_view {input}, serial);
+
+    auto parallel_state = Utf8
+            ? vtdec::decode_utf8_parallel(input, parallel, exec, {}, vtdec::decode_config {}, chunk)
+            : vtdec::decode_parallel(input, parallel, exec, {}, vtdec::decode_config {}, chunk);
+
+    auto diff = compare(Utf8 ? "utf8" : "octets", serial.events, parallel.events);
+    check(diff.empty(), diff.c_str());
+
+    check(serial_state.state == parallel_state.state && serial_state.sequence == parallel_state.sequence
+            && serial_state.utf8_remaining == parallel_state.utf8_remaining, "final state");
+}
+
+registrar r1 {"parallel/random", [] {
+    xorshift rng {31337};
+    vtdec::session_executor exec {4};
+
+    for (int i = 0; i < 40; ++i)
+    {
+        auto input = random_stream(rng, 1 << 14);
+
+        for (std::size_t chunk : {64, 257, 4096})
+        {
+            check_stream<false>(input, exec, chunk);
+            check_stream<true>(input, exec, chunk);
+        }
+    }
+}};
+
+registrar r2 {"parallel/serial", [] {
+    xorshift rng {5};
+    auto input = random_stream(rng, 1 << 12);
+
+    // A traced processor and a lone worker both fall back to decoding serially
+    vtdec::session_executor one {1};
+    vtdec::session_executor many {3};
+
+    reference serial;
+    reference traced;
+    vtdec::decode(std::string_view {input}, serial);
+    vtdec::decode_parallel(input, traced, many, {}, vtdec::decode_config {}, 64);
+    check(serial.full == traced.full, "traced");
+
+    check_stream<false>(input, one, 64);
+
+    counter count;
+    vtdec::decode_parallel(input, count, many, {}, vtdec::decode_config {}, 64);
+    check(count.begins == 1 && count.ends == 1, "one decode operation");
+}};
+
+registrar r3 {"parallel/exception", [] {
+    // A processor that throws partway through, while the workers are on the next round
+    struct thrower : vtdec::static_processor<thrower>
+    {
+        int left = 200;
+
+        void ctl_end(bool cancel)
+        {
+            if (--left == 0)
+            {
+                throw std::runtime_error {"enough"};
+            }
+        }
+    };
+
+    xorshift rng {77};
+    auto input = random_stream(rng, 1 << 14);
+    vtdec::session_executor exec {4};
+
+    auto thrown = false;
+
+    try
+    {
+        thrower proc;
+        vtdec::decode_parallel(input, proc, exec, {}, vtdec::decode_config {}, 64);
+    }
+    catch (const std::runtime_error&)
+    {
+        thrown = true;
+    }
+
+    check(thrown, "exception passed to the caller");
+
+    // The executor is still usable afterward
+    check_stream<false>(input, exec, 64);
+}};
+
+} // namespace
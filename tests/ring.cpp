@@ -0,0 +1,147 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Checks the byte ring on its own and as a pipe between a producer thread and
+ * a decoder.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <vtdec/decoder.h>
+#include <vtdec/ring.h>
+
+#include "differential.h"
+#include "harness.h"
+
+using namespace vtdec::test;
+
+namespace
+{
+
+registrar r1 {"ring/wrap", [] {
+    vtdec::byte_ring ring {12};
+
+    check(ring.capacity() == 16, "capacity rounded up");
+    check(ring.peek().empty(), "empty at first");
+
+    check(ring.write("0123456789", 10) == 10, "write fits");
+    check(ring.peek().first == "0123456789" && ring.peek().second.empty(), "one span");
+    ring.consume(10);
+
+    // The next write wraps around the end
+    check(ring.write("abcdefghijkl", 12) == 12, "write wraps");
+
+    auto view = ring.peek();
+    check(view.first == "abcdef" && view.second == "ghijkl", "two spans");
+
+    check(ring.write("mnopqrst", 8) == 4, "write clipped when full");
+    check(ring.prepare().size() == 0, "no space when full");
+
+    ring.consume(6);
+
+    auto space = ring.prepare();
+    check(space.size() == 6 && space.first_size == 6 && space.second_size == 0, "space after consume");
+
+    space.first[0] = 'u';
+    ring.commit(1);
+
+    view = ring.peek();
+    check(view.first == "ghijklmnopu" && view.second.empty(), "spans after commit");
+
+    ring.consume(view.size());
+
+    space = ring.prepare();
+    check(space.first_size == 5 && space.second == space.first - 11 && space.second_size == 11, "space wraps");
+}};
+
+registrar r2 {"ring/threads", [] {
+    using processor = recorder<vtdec::table_backend_fused, false>;
+
+    xorshift rng {2024};
+
+    for (int round = 0; round < 20; ++round)
+    {
+        auto input = random_terminal_input(rng, 1 << 14);
+
+        // A tiny ring wraps around all the time
+        vtdec::byte_ring ring {64};
+        std::atomic<bool> done {false};
+
+        std::thread producer {[&] {
+            for_each_chunk(input, rng(), [&](std::string_view chunk) {
+                while (!chunk.empty())
+                {
+                    chunk.remove_prefix(ring.write(chunk.data(), chunk.size()));
+                    std::this_thread::yield();
+                }
+            });
+
+            done.store(true, std::memory_order_release);
+        }};
+
+        processor piped;
+        vtdec::decoder<processor> dec {piped};
+
+        for (;;)
+        {
+            // Check done first, so nothing written before it is missed
+            auto last = done.load(std::memory_order_acquire);
+
+            if (vtdec::drain(ring, dec) == 0)
+            {
+                if (last)
+                {
+                    break;
+                }
+
+                std::this_thread::yield();
+            }
+        }
+
+        producer.join();
+        dec.flush();
+
+        processor whole;
+        vtdec::decoder<processor> ref {whole};
+        ref.feed(input);
+        ref.flush();
+
+        auto diff = compare("ring", whole.events, piped.events);
+
+        if (!check(diff.empty(), diff.c_str()))
+        {
+            return;
+        }
+    }
+}};
+
+} // namespace
@@ -0,0 +1,96 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Checks every scanner variant against the scalar one.
+ */
+
+#include <string>
+
+#include <vtdec/scan.h>
+
+#include "differential.h"
+#include "harness.h"
+
+using namespace vtdec::test;
+
+namespace
+{
+
+/**
+ * Check each variant for one class of stop octets on random buffers, at every
+ * start offset.
+ */
+template<class Stops>
+void check_stops(const char* name)
+{
+    namespace d = vtdec::detail;
+
+    xorshift rng {99};
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        std::string buf(rng() % 100, ' ');
+
+        for (auto& c : buf)
+        {
+            // Mostly plain text, with a stop now and then
+            c = static_cast<char>(rng() % 24 ? 0x20 + rng() % 0x5f : rng());
+        }
+
+        auto end = buf.data() + buf.size();
+
+        for (auto begin = buf.data(); begin != end; ++begin)
+        {
+            auto expected = d::scan_scalar<Stops>(begin, end);
+
+            check(d::scan_swar<Stops>(begin, end) == expected, std::string {name} + " swar");
+#if defined(VTDEC_SCAN_SSE2)
+            check(d::scan_sse2<Stops>(begin, end) == expected, std::string {name} + " sse2");
+#endif
+#if defined(VTDEC_SCAN_AVX2)
+            check(d::scan_avx2<Stops>(begin, end) == expected, std::string {name} + " avx2");
+#endif
+        }
+    }
+}
+
+registrar r1 {"scan/text", [] { check_stops<vtdec::detail::text_stops>("text"); }};
+registrar r2 {"scan/dcs", [] { check_stops<vtdec::detail::dcs_stops>("dcs"); }};
+
+registrar r3 {"scan/stops", [] {
+    for (int c = 0; c < 256; ++c)
+    {
+        auto u = static_cast<unsigned char>(c);
+
+        check(vtdec::detail::text_stops::scalar(u) == (c < 0x20 || c >= 0x7f), "text stop " + std::to_string(c));
+        check(vtdec::detail::dcs_stops::scalar(u) == (c == 0x18 || c == 0x1a || c == 0x1b || c >= 0x7f),
+                "dcs stop " + std::to_string(c));
+    }
+}};
+
+} // namespace
@@ -0,0 +1,156 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Checks how control sequences and device control strings are parsed into
+ * csi_sequence, case by case.
+ */
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include <vtdec/decode.h>
+
+#include "harness.h"
+
+using namespace vtdec::test;
+
+namespace
+{
+
+/**
+ * A processor that describes the last sequence it was handed.
+ */
+struct capture : vtdec::static_processor<capture>
+{
+    std::string last;
+
+    void describe(const char* kind, const vtdec::csi_sequence& seq, char final)
+    {
+        last = std::string {kind} + " f=" + final + " m=" + (seq.private_marker ? seq.private_marker : '-') + " p=";
+
+        for (std::size_t i = 0; i < seq.param_count; ++i)
+        {
+            last += (seq.is_subparam(i) ? ":" : i ? ";" : "") + std::to_string(seq.params[i]);
+        }
+
+        last += " i=" + std::string(seq.intermediates, seq.intermediate_count) + " o=" + (seq.overflow ? '1' : '0');
+    }
+
+    void csi_dispatch(const vtdec::csi_sequence& seq, char final)
+    { describe("csi", seq, final); }
+
+    void dcs_hook(const vtdec::csi_sequence& seq, char final)
+    { describe("dcs", seq, final); }
+};
+
+/**
+ * A case: an input, whether it is decoded as UTF-8 rather than as octets, and
+ * the description of the last sequence.
+ */
+struct sequence_case
+{
+    std::string_view input;
+    bool utf8;
+    const char* expected;
+};
+
+std::string many_params(std::size_t n)
+{
+    std::string out = "\x1b[";
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        out += std::to_string(i + 1) + ';';
+    }
+
+    return out + 'm';
+}
+
+const std::string forty = many_params(40);
+
+const sequence_case cases[] = {
+        // Parameters
+        {"\x1b[m", false, "csi f=m m=- p= i= o=0"},
+        {"\x1b[1;31m", false, "csi f=m m=- p=1;31 i= o=0"},
+        {"\x1b[;5H", false, "csi f=H m=- p=0;5 i= o=0"},
+        {"\x1b[3;J", false, "csi f=J m=- p=3;0 i= o=0"},
+
+        // Colon sub-parameters
+        {"\x1b[38:2::255:128:0m", false, "csi f=m m=- p=38:2:0:255:128:0 i= o=0"},
+        {"\x1b[4:3;58:5:9m", false, "csi f=m m=- p=4:3;58:5:9 i= o=0"},
+
+        // Private markers and intermediates
+        {"\x1b[?1049h", false, "csi f=h m=? p=1049 i= o=0"},
+        {"\x1b[>4;2m", false, "csi f=m m=> p=4;2 i= o=0"},
+        {"\x1b[2 q", false, "csi f=q m=- p=2 i=  o=0"},
+        {"\x1b[!p", false, "csi f=p m=- p= i=! o=0"},
+        {"\x1b[1$#|", false, "csi f=| m=- p=1 i=$# o=0"},
+        {"\x1b[1$#!|", false, "csi f=| m=- p=1 i=$# o=1"},
+
+        // Overflow past 32 parameters, and saturation at 65535
+        {forty, false,
+                "csi f=m m=- p=1;2;3;4;5;6;7;8;9;10;11;12;13;14;15;16;17;18;19;20;21;22;23;24;25;26;27;28;29;30;31;32"
+                " i= o=1"},
+        {"\x1b[65535;65536;99999999m", false, "csi f=m m=- p=65535;65535;65535 i= o=0"},
+
+        // GR octets stand in for GL, finals included
+        {"\x1b[1\xbb" "2\xed", false, "csi f=m m=- p=1;2 i= o=0"},
+        {"\x9b\xbf" "25\xec", false, "csi f=l m=? p=25 i= o=0"},
+        {"\x1b[2\xa0\xf1", false, "csi f=q m=- p=2 i=  o=0"},
+
+        // A wide codepoint is keyed as a space, and collected as one
+        {"\x1b[1\xe4\xb8\xadq", true, "csi f=q m=- p=1 i=  o=0"},
+        {"\x1b[1\xc2\xabq", true, "csi f=q m=- p=1 i=  o=0"},
+
+        // Device control strings
+        {"\x1bP1;2|x\x1b\\", false, "dcs f=| m=- p=1;2 i= o=0"},
+        {"\x1bP0;1;8q#0\x1b\\", false, "dcs f=q m=- p=0;1;8 i= o=0"},
+        {"\x1bP>1$qm\x1b\\", false, "dcs f=q m=> p=1 i=$ o=0"},
+        {"\x90" "1\xbb" "2\xfc" "x\x9c", false, "dcs f=| m=- p=1;2 i= o=0"},
+};
+
+registrar r1 {"sequence/cases", [] {
+    for (auto&& c : cases)
+    {
+        capture proc;
+
+        if (c.utf8)
+        {
+            vtdec::decode_utf8(c.input, proc);
+        }
+        else
+        {
+            vtdec::decode(c.input, proc);
+        }
+
+        check(proc.last == c.expected, std::string {c.expected} + " but got " + proc.last);
+    }
+}};
+
+} // namespace
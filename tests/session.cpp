@@ -0,0 +1,145 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Checks that sessions fed in interleaved batches decode the same as each
+ * would on its own.
+ */
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <vtdec/decoder.h>
+#include <vtdec/session.h>
+
+#include "differential.h"
+#include "harness.h"
+
+using namespace vtdec::test;
+
+namespace
+{
+
+registrar r1 {"session/batches", [] {
+    using processor = recorder<vtdec::table_backend_fused, false>;
+
+    xorshift rng {4242};
+
+    for (int round = 0; round < 20; ++round)
+    {
+        constexpr std::size_t sessions = 64;
+
+        std::vector<std::string> inputs(sessions);
+        std::vector<std::string_view> rest(sessions);
+        std::size_t left = 0;
+
+        for (std::size_t i = 0; i < sessions; ++i)
+        {
+            inputs[i] = random_terminal_input(rng, rng() % 512);
+
+            rest[i] = inputs[i];
+            left += !rest[i].empty();
+        }
+
+        vtdec::session_pool<processor> pool;
+        pool.reserve(sessions);
+
+        for (std::size_t i = 0; i < sessions; ++i)
+        {
+            check(pool.open() == i, "session index");
+        }
+
+        // Feed random pieces of random sessions, a batch at a time, until all input is gone
+        while (left != 0)
+        {
+            std::vector<vtdec::session_input> batch;
+
+            for (int j = 0; j < 32; ++j)
+            {
+                auto i = rng() % sessions;
+                auto piece = rest[i].substr(0, rng() % 24);
+                batch.push_back({i, piece});
+
+                if (!rest[i].empty() && piece.size() == rest[i].size())
+                {
+                    --left;
+                }
+
+                rest[i].remove_prefix(piece.size());
+            }
+
+            pool.feed(batch.begin(), batch.end());
+        }
+
+        for (std::size_t i = 0; i < sessions; ++i)
+        {
+            pool.flush(i);
+
+            processor whole;
+            vtdec::decoder<processor> dec {whole};
+            dec.feed(inputs[i]);
+            dec.flush();
+
+            auto diff = compare("session", whole.events, pool.target(i).events);
+
+            if (!check(diff.empty(), diff.c_str()))
+            {
+                return;
+            }
+        }
+    }
+}};
+
+registrar r2 {"session/begin_end", [] {
+    vtdec::session_pool<counter> pool;
+    auto a = pool.open();
+    auto b = pool.open();
+
+    pool.feed(a, "z");
+
+    vtdec::session_input batch[] {{a, "x"}, {b, "\x1b["}, {a, "y"}, {b, "1m"}, {a, "\x1b"}};
+    pool.feed(std::begin(batch), std::end(batch));
+
+    check(pool.target(a).begins == 1 && pool.target(a).ends == 0, "one begin over many feeds");
+    check(pool.state(a).state == vtdec::state::escape, "state carried");
+
+    pool.finish(a);
+    pool.finish(b);
+    pool.finish(b);
+
+    check(pool.target(a).ends == 1 && pool.target(b).ends == 1, "one end on finish");
+    check(pool.state(a).state == vtdec::state::escape, "state kept on finish");
+
+    pool.flush(a);
+
+    check(pool.target(a).begins == 2 && pool.target(a).ends == 2, "flush begins and ends");
+    check(pool.state(a).state == vtdec::state::ground, "flush goes to ground");
+}};
+
+} // namespace
@@ -0,0 +1,178 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Checks that a stream decodes the same however it is split, and that it
+ * ends cleanly on flush.
+ */
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <vtdec/decode.h>
+#include <vtdec/decoder.h>
+
+#include "differential.h"
+#include "harness.h"
+
+using namespace vtdec::test;
+
+namespace
+{
+
+/**
+ * A processor that takes one codepoint at a time and writes down every
+ * callback, including decode_begin and decode_end.
+ */
+struct strict : vtdec::static_processor<strict>
+{
+    std::string log;
+
+    void add(const char* name, std::uint32_t arg = 0)
+    { log += std::string {name} + ' ' + std::to_string(arg) + '\n'; }
+
+    void print(char32_t c)
+    { add("print", c); }
+
+    void ctl(char c)
+    { add("ctl", static_cast<unsigned char>(c)); }
+
+    void ctl_begin()
+    { add("ctl_begin"); }
+
+    void ctl_put(char32_t c)
+    { add("ctl_put", c); }
+
+    void csi_dispatch(const vtdec::csi_sequence& seq, char final)
+    { add("csi_dispatch", seq.param(0) << 8 | static_cast<unsigned char>(final)); }
+
+    void ctl_end(bool cancel)
+    { add("ctl_end", cancel); }
+
+    void dcs_begin()
+    { add("dcs_begin"); }
+
+    void dcs_put(char32_t c)
+    { add("dcs_put", c); }
+
+    void dcs_end(bool cancel)
+    { add("dcs_end", cancel); }
+
+    void osc_begin()
+    { add("osc_begin"); }
+
+    void osc_put(char32_t c)
+    { add("osc_put", c); }
+
+    void osc_end(bool cancel)
+    { add("osc_end", cancel); }
+
+    void decode_begin()
+    { add("decode_begin"); }
+
+    void decode_end(bool cancel)
+    { add("decode_end", cancel); }
+};
+
+/**
+ * Decode a stream in chunks of the given size, or split at random if zero,
+ * and flush it.
+ */
+std::string decode_split(std::string_view input, std::size_t size, std::uint32_t seed = 1)
+{
+    strict proc;
+    vtdec::decoder<strict> dec {proc};
+
+    if (size == 0)
+    {
+        for_each_chunk(input, seed, [&](std::string_view chunk) { dec.feed(chunk); });
+    }
+    else
+    {
+        for (std::size_t i = 0; i < input.size(); i += size)
+        {
+            dec.feed(input.substr(i, size));
+        }
+    }
+
+    dec.flush();
+    return proc.log;
+}
+
+registrar r1 {"stream/splits", [] {
+    xorshift rng {777};
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        auto input = random_terminal_input(rng, rng() % 128);
+
+        auto whole = decode_split(input, input.size() + 1);
+
+        if (!check(decode_split(input, 1) == whole, "one octet at a time")
+                || !check(decode_split(input, 3) == whole, "three octets at a time")
+                || !check(decode_split(input, 0, rng()) == whole, "random splits"))
+        {
+            return;
+        }
+    }
+}};
+
+registrar r2 {"stream/flush", [] {
+    static const struct
+    {
+        const char* input;
+        const char* tail;
+    } cases[] = {
+            {"a\xe4\xb8", "print 65533\ndecode_end 0\n"},
+            {"\x1b[12", "ctl_end 1\ndecode_end 0\n"},
+            {"\x1b]0;ti", "osc_end 1\ndecode_end 0\n"},
+            {"\x1bP1q#0", "dcs_end 1\ndecode_end 0\n"},
+            {"\x1b", "decode_end 0\n"},
+            {"done", "decode_end 0\n"},
+    };
+
+    for (auto& c : cases)
+    {
+        strict proc;
+        vtdec::decoder<strict> dec {proc};
+        dec.feed(c.input);
+
+        auto before = proc.log.size();
+        dec.flush();
+
+        check(proc.log.substr(before) == c.tail, std::string {"flush after "} + c.input);
+        check(dec.state().state == vtdec::state::ground, "ground after flush");
+
+        // The next stream starts afresh
+        proc.log.clear();
+        dec.feed("x");
+        check(proc.log == "decode_begin 0\nprint 120\n", "fresh stream after flush");
+    }
+}};
+
+} // namespace
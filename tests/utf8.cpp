@@ -0,0 +1,149 @@
+/*
+ * vtdec
+ * Copyright 2018 Tyler Filla
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Huge thanks to Joshua Haberman for vtparse and Paul Williams for the state
+ * machine underlying vtdec. All third-party contributions made to vtparse are
+ * assumed to have been dedicated to the public domain.
+ */
+
+/*
+ * Checks how UTF-8 input is assembled into codepoints, and how ill-formed
+ * input is replaced, case by case.
+ */
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include <vtdec/decode.h>
+#include <vtdec/decoder.h>
+
+#include "harness.h"
+
+using namespace vtdec::test;
+
+namespace
+{
+
+/**
+ * A processor that writes down the codepoints it prints.
+ */
+struct capture : vtdec::static_processor<capture>
+{
+    std::u32string out;
+
+    void print(char32_t c)
+    { out += c; }
+};
+
+/**
+ * Describe codepoints in hexadecimal.
+ */
+std::string describe(std::u32string_view str)
+{
+    std::string out;
+
+    for (auto c : str)
+    {
+        char buf[16];
+        std::snprintf(buf, sizeof(buf), "%s%x", out.empty() ? "" : " ", static_cast<unsigned>(c));
+        out += buf;
+    }
+
+    return out;
+}
+
+/**
+ * A case: an input and the codepoints printed for it.
+ */
+struct utf8_case
+{
+    std::string_view input;
+    std::u32string_view expected;
+};
+
+const utf8_case cases[] = {
+        // Well-formed sequences of every length, at the edges of their ranges
+        {"a", U"a"},
+        {"\xc2\xa0\xc3\xa9\xdf\xbf", U"\u00a0\u00e9\u07ff"},
+        {"\xe0\xa0\x80\xe4\xb8\xad\xed\x9f\xbf\xee\x80\x80\xef\xbf\xbd", U"\u0800\u4e2d\ud7ff\ue000\ufffd"},
+        {"\xf0\x90\x80\x80\xf0\x9f\x98\x80\xf4\x8f\xbf\xbf", U"\U00010000\U0001f600\U0010ffff"},
+
+        // Overlong forms, one U+FFFD per octet
+        {"\xc0\xaf", U"\ufffd\ufffd"},
+        {"\xc1\xbf", U"\ufffd\ufffd"},
+        {"\xe0\x80\x80", U"\ufffd\ufffd\ufffd"},
+        {"\xe0\x9f\xbf", U"\ufffd\ufffd\ufffd"},
+        {"\xf0\x8f\xbf\xbf", U"\ufffd\ufffd\ufffd\ufffd"},
+
+        // Surrogates
+        {"\xed\xa0\x80", U"\ufffd\ufffd\ufffd"},
+        {"\xed\xbf\xbf", U"\ufffd\ufffd\ufffd"},
+
+        // Beyond U+10FFFF
+        {"\xf4\x90\x80\x80", U"\ufffd\ufffd\ufffd\ufffd"},
+        {"\xf5\x80\x80\x80", U"\ufffd\ufffd\ufffd\ufffd"},
+        {"\xf8\x88\x80\x80\x80", U"\ufffd\ufffd\ufffd\ufffd\ufffd"},
+        {"\xfe\xff", U"\ufffd\ufffd"},
+
+        // Stray continuations
+        {"\x80", U"\ufffd"},
+        {"a\x80\xbf" "b", U"a\ufffd\ufffdb"},
+
+        // Sequences cut short, one U+FFFD per maximal subpart, then the octet afresh
+        {"\xe4\xb8" "a", U"\ufffda"},
+        {"\xf0\x9f\x98" "a", U"\ufffda"},
+        {"\xc3\xc3\xa9", U"\ufffd\u00e9"},
+        {"\xe4\xb8", U"\ufffd"},
+
+        // The example from the Unicode standard, section 3.9
+        {"\x61\xf1\x80\x80\xe1\x80\xc2\x62\x80\x63\x80\xbf\x64",
+                U"a\ufffd\ufffd\ufffdb\ufffdc\ufffd\ufffdd"},
+};
+
+registrar r1 {"utf8/cases", [] {
+    for (auto&& c : cases)
+    {
+        // In one piece, then an octet at a time
+        capture whole;
+        vtdec::decoder<capture> dec {whole};
+        dec.feed(c.input);
+        dec.flush();
+
+        check(whole.out == c.expected, describe(c.expected) + " but got " + describe(whole.out));
+
+        capture split;
+        vtdec::decoder<capture> octets {split};
+
+        for (std::size_t i = 0; i < c.input.size(); ++i)
+        {
+            octets.feed(c.input.substr(i, 1));
+        }
+
+        octets.flush();
+
+        check(split.out == c.expected, describe(c.expected) + " but got " + describe(split.out) + " octet by octet");
+    }
+}};
+
+} // namespace